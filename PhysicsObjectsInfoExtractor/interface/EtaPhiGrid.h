@@ -0,0 +1,154 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_EtaPhiGrid_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_EtaPhiGrid_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       EtaPhiGrid.h
+//
+/**\file EtaPhiGrid.h
+
+ Description: [Eta-phi binned grid of objects for fast DeltaR matching]
+
+ Implementation:
+     The objects of one event are put into square eta-phi cells of side
+     dRMax (phi cells are slightly larger so that they tile 2pi exactly).
+     Any object within dRMax of a point is then in the 3x3 cells around
+     it, so each query looks at a handful of candidates instead of all
+     the objects of the event.  The phi index wraps around, and objects
+     beyond |eta| = etaMax are kept in the outermost eta cells.
+
+     Only the occupied cells are stored: build() sorts the objects by cell
+     and a query binary-searches the 9 cells it needs, so the cost per
+     event depends on the number of objects, not on the number of cells.
+     Cells are never smaller than kEtaPhiGridMinCellSize, which keeps the cell
+     numbers small for a tiny dRMax (the 3x3 search is still exact).
+
+       EtaPhiGrid grid(0.4);
+       for(...) grid.insert(eta[i], phi[i], i);
+       grid.build();
+       float dr;
+       int j = grid.nearest(eta0, phi0, -1, dr); //-1 if none within 0.4
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+//
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//smallest cell side, whatever dRMax is
+const double kEtaPhiGridMinCellSize = 0.01;
+
+class EtaPhiGrid {
+ public:
+  explicit EtaPhiGrid(double dRMax, double etaMax = 5.0)
+    : dRMax_(dRMax), etaMax_(etaMax), cellSize_(std::max(dRMax, kEtaPhiGridMinCellSize))
+  {
+    nEta_ = static_cast<int>(std::ceil(2*etaMax_/cellSize_));
+    if(nEta_<1) nEta_ = 1;
+    nPhi_ = static_cast<int>(std::floor(2*M_PI/cellSize_));
+    if(nPhi_<1) nPhi_ = 1;
+  }
+
+  static float deltaPhi(float phi1, float phi2)
+  {
+    float dphi = std::fabs(phi1-phi2);
+    if(dphi>M_PI) dphi = 2*M_PI-dphi;
+    return dphi;
+  }
+
+  static float deltaR(float eta1, float phi1, float eta2, float phi2)
+  {
+    float deta = eta1-eta2;
+    float dphi = deltaPhi(phi1,phi2);
+    return std::sqrt(deta*deta+dphi*dphi);
+  }
+
+  //forget the objects of the previous event
+  void clear() { points_.clear(); }
+
+  //add an object; index is what nearest() gives back
+  void insert(float eta, float phi, int index)
+  {
+    Point p;
+    p.eta = eta;
+    p.phi = phi;
+    p.index = index;
+    p.cell = cellOf(etaBin(eta),phiBin(phi));
+    points_.push_back(p);
+  }
+
+  //sort the objects by cell
+  void build() { std::sort(points_.begin(),points_.end()); }
+
+  //index of the closest object within dRMax (other than skipIndex),
+  //or -1 if there is none.  dR is set to its distance.
+  int nearest(float eta, float phi, int skipIndex, float& dR) const
+  {
+    int best = -1;
+    dR = dRMax_;
+    int ie = etaBin(eta);
+    int ip = phiBin(phi);
+    for(int de=-1;de<=1;de++){
+      int e = ie+de;
+      if(e<0 || e>=nEta_) continue;
+      //with fewer than 3 phi cells the neighbours would repeat
+      int npcells = nPhi_<3 ? nPhi_ : 3;
+      for(int k=0;k<npcells;k++){
+        int p = nPhi_<3 ? k : (ip+k-1+nPhi_)%nPhi_;
+        Point key;
+        key.cell = cellOf(e,p);
+        std::pair<PointIter,PointIter> range = std::equal_range(points_.begin(),points_.end(),key);
+        for(PointIter it=range.first;it!=range.second;++it){
+          const Point& pt = *it;
+          if(pt.index==skipIndex) continue;
+          float d = deltaR(eta,phi,pt.eta,pt.phi);
+          if(d<dR || (d==dR && best<0)){
+            dR = d;
+            best = pt.index;
+          }
+        }
+      }
+    }
+    return best;
+  }
+
+ private:
+  struct Point {
+    float eta, phi;
+    int index;
+    int cell;
+    bool operator<(const Point& other) const { return cell<other.cell; }
+  };
+  typedef std::vector<Point>::const_iterator PointIter;
+
+  int etaBin(float eta) const
+  {
+    int b = static_cast<int>(std::floor((eta+etaMax_)/cellSize_));
+    if(b<0) b = 0;
+    if(b>=nEta_) b = nEta_-1;
+    return b;
+  }
+
+  int phiBin(float phi) const
+  {
+    double x = phi/(2*M_PI);
+    x -= std::floor(x);
+    int b = static_cast<int>(x*nPhi_);
+    return b>=nPhi_ ? 0 : b;
+  }
+
+  int cellOf(int e, int p) const { return e*nPhi_+p; }
+
+  double dRMax_;
+  double etaMax_;
+  double cellSize_;
+  int nEta_;
+  int nPhi_;
+  std::vector<Point> points_;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MemoryWatchdog_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MemoryWatchdog_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MemoryWatchdog.h
+//
+/**\file MemoryWatchdog.h
+
+ Description: [Cheap resident memory (RSS) watchdog for a per-job memory budget]
+
+ Implementation:
+     Every checkInterval events the RSS of the job is read from
+     /proc/self/statm (one small read).  When it goes above highFraction
+     of the budget, check() returns kMemoryPressure and the extractor is
+     expected to flush its buffers and use smaller ones from then on.
+
+     Flushing does not always give memory back to the system, so once
+     check() has fired it only fires again if the RSS kept growing (by
+     kWatchdogMinGrowth of the budget) since then, and the number of
+     checks skipped after each of these repeated events doubles, up to
+     kWatchdogMaxBackoff.  Everything is re-armed when the RSS falls
+     below lowFraction of the budget.  From then on, each check that
+     finds the RSS still below lowFraction returns kMemoryRoom, once per
+     earlier kMemoryPressure, so that the extractor can double its
+     buffers back, step by step, towards their configured sizes.
+     The high-water mark is taken from VmHWM in /proc/self/status, so it
+     also covers the peaks between two checks.  A budget of 0 disables
+     the watchdog.
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+//growth of the RSS, as a fraction of the budget, needed to react again
+const double kWatchdogMinGrowth = 0.02;
+//most checks skipped after a repeated pressure event
+const unsigned int kWatchdogMaxBackoff = 64;
+
+//what check() found
+enum MemoryState {
+  kMemoryOk,        //nothing to do
+  kMemoryPressure,  //close to the budget: flush and shrink the buffers
+  kMemoryRoom       //well under the budget again: grow them back one step
+};
+
+class MemoryWatchdog {
+ public:
+  MemoryWatchdog(double budgetMB, unsigned int checkInterval,
+                 double highFraction = 0.8, double lowFraction = 0.7)
+    : budgetMB_(budgetMB), checkInterval_(checkInterval ? checkInterval : 1),
+      highFraction_(highFraction), lowFraction_(lowFraction), count_(0),
+      nPressure_(0), nShrunk_(0), maxSeenMB_(0), lastPressureMB_(0), backoff_(1), skip_(0) {}
+
+  bool enabled() const { return budgetMB_>0; }
+  double budgetMB() const { return budgetMB_; }
+
+  //call once per event
+  MemoryState check()
+  {
+    if(!enabled() || ++count_<checkInterval_) return kMemoryOk;
+    count_ = 0;
+    double rss = rssMB();
+    if(rss>maxSeenMB_) maxSeenMB_ = rss;
+    if(rss<lowFraction_*budgetMB_){
+      lastPressureMB_ = 0;
+      backoff_ = 1;
+      skip_ = 0;
+      if(nShrunk_>0){
+        --nShrunk_;
+        return kMemoryRoom;
+      }
+      return kMemoryOk;
+    }
+    if(rss<highFraction_*budgetMB_) return kMemoryOk;
+    if(skip_>0){
+      --skip_;
+      return kMemoryOk;
+    }
+    if(lastPressureMB_>0){
+      //already reacted at this level: only again if it kept growing
+      if(rss<lastPressureMB_+kWatchdogMinGrowth*budgetMB_) return kMemoryOk;
+      backoff_ = std::min(2*backoff_, kWatchdogMaxBackoff);
+    }
+    skip_ = backoff_;
+    lastPressureMB_ = rss;
+    ++nPressure_;
+    ++nShrunk_;
+    return kMemoryPressure;
+  }
+
+  //number of times check() found the job close to its budget
+  unsigned int nPressure() const { return nPressure_; }
+
+  //current resident memory, in MB (0 if it cannot be read)
+  static double rssMB()
+  {
+    FILE* f = fopen("/proc/self/statm","r");
+    if(!f) return 0;
+    long size = 0, resident = 0;
+    int n = fscanf(f,"%ld %ld",&size,&resident);
+    fclose(f);
+    if(n!=2) return 0;
+    return resident*(sysconf(_SC_PAGESIZE)/1024.)/1024.;
+  }
+
+  //peak resident memory of the job, in MB
+  double highWaterMB() const
+  {
+    double hwm = maxSeenMB_;
+    FILE* f = fopen("/proc/self/status","r");
+    if(!f) return hwm;
+    char line[256];
+    while(fgets(line,sizeof(line),f)){
+      long kb;
+      if(strncmp(line,"VmHWM:",6)==0 && sscanf(line+6,"%ld",&kb)==1){
+        if(kb/1024.>hwm) hwm = kb/1024.;
+        break;
+      }
+    }
+    fclose(f);
+    return hwm;
+  }
+
+ private:
+  double budgetMB_;
+  unsigned int checkInterval_;
+  double highFraction_;
+  double lowFraction_;
+  unsigned int count_;
+  unsigned int nPressure_;
+  unsigned int nShrunk_; //pressure events not yet answered by kMemoryRoom
+  double maxSeenMB_;
+  double lastPressureMB_;
+  unsigned int backoff_;
+  unsigned int skip_;
+};
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonBinaryFormat_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonBinaryFormat_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MuonBinaryFormat.h
+//
+/**\file MuonBinaryFormat.h
+
+ Description: [Layout of the compact binary muon output (MuonObjectInfo.bin)]
+
+ Implementation:
+     File header (6 bytes):
+       "MUOB", version (uint8), encoding flags (uint8, see kHalfPtEnergy)
+     Then the events, grouped in row groups.  The delta coding of run and
+     event restarts at each row group, so any of them can be decoded alone.
+     One record per event:
+       run, event      : zig-zag delta varints (see MuonCompactEncoding.h)
+       nmu             : varint
+       nmu times:
+         flags         : uint8 (charge, isGlobal, isTracker)
+         pt, energy    : half float (uint16) or float32, per the header
+         eta, phi      : 16-bit fixed point
+     After the last row group comes the footer:
+       one zone map per row group (see MuonZoneMap.h)
+       footer offset (uint64), number of row groups (uint32), "MUOZ"
+     All multi-byte values are little endian.  px, py and pz are not
+     stored since they follow from pt, eta and phi.
+
+     MuonBinaryReader reads the footer first and then only the row groups
+     whose zone map can match the requested selection.
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonCompactEncoding.h"
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonZoneMap.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+namespace muoncompact {
+
+  const char kBinaryMagic[4] = {'M','U','O','B'};
+  const uint8_t kBinaryVersion = 2;
+  const size_t kBinaryHeaderSize = 6;
+  const char kFooterMagic[4] = {'M','U','O','Z'};
+  const size_t kTrailerSize = 16;
+
+  //encoding flags stored in the file header
+  const uint8_t kHalfPtEnergy = 0x1; //pt and energy are half floats
+
+  //one decoded muon
+  struct MuonBinaryMuon {
+    uint8_t flags;
+    float pt;
+    float e;
+    float eta;
+    float phi;
+
+    int charge() const { return unpackCharge(flags); }
+    bool isGlobal() const { return unpackIsGlobal(flags); }
+    bool isTracker() const { return unpackIsTracker(flags); }
+    float px() const { return pt*std::cos(phi); }
+    float py() const { return pt*std::sin(phi); }
+    float pz() const { return pt*std::sinh(eta); }
+  };
+
+  //one decoded event
+  struct MuonBinaryEvent {
+    uint64_t run;
+    uint64_t event;
+    std::vector<MuonBinaryMuon> muons;
+  };
+
+  inline void putBinaryHeader(std::vector<unsigned char>& out, uint8_t encoding)
+  {
+    out.insert(out.end(), kBinaryMagic, kBinaryMagic+4);
+    out.push_back(kBinaryVersion);
+    out.push_back(encoding);
+  }
+
+  //returns false if this is not a file we know how to read
+  inline bool getBinaryHeader(const unsigned char* in, size_t len, uint8_t& encoding)
+  {
+    if(len<kBinaryHeaderSize) return false;
+    if(memcmp(in, kBinaryMagic, 4)!=0 || in[4]!=kBinaryVersion) return false;
+    encoding = in[5];
+    return true;
+  }
+
+  inline void putPtEnergy(std::vector<unsigned char>& out, uint8_t encoding, float value)
+  {
+    if(encoding & kHalfPtEnergy) putU16(out, floatToHalf(value));
+    else putFloat(out, value);
+  }
+
+  inline void putMuon(std::vector<unsigned char>& out, uint8_t encoding, const MuonBinaryMuon& mu)
+  {
+    out.push_back(mu.flags);
+    putPtEnergy(out, encoding, mu.pt);
+    putPtEnergy(out, encoding, mu.e);
+    putU16(out, encodeEta(mu.eta));
+    putU16(out, encodePhi(mu.phi));
+  }
+
+  inline size_t muonRecordSize(uint8_t encoding)
+  {
+    return (encoding & kHalfPtEnergy) ? 9 : 13;
+  }
+
+  //decode one event record; returns the number of bytes read,
+  //or 0 if the buffer ended in the middle of the record
+  inline size_t getEvent(const unsigned char* in, size_t len, uint8_t encoding,
+                         DeltaCoder& coder, MuonBinaryEvent& evt)
+  {
+    size_t pos = coder.decode(in, len, evt.run, evt.event);
+    if(!pos) return 0;
+    uint64_t nmu;
+    size_t n = getVarint(in+pos, len-pos, nmu);
+    if(!n) return 0;
+    pos += n;
+    size_t musize = muonRecordSize(encoding);
+    if(nmu>(len-pos)/musize) return 0;
+    bool half = encoding & kHalfPtEnergy;
+    evt.muons.resize(nmu);
+    for(uint64_t j=0;j<nmu;j++){
+      MuonBinaryMuon& mu = evt.muons[j];
+      const unsigned char* p = in+pos;
+      mu.flags = p[0];
+      if(half){
+        mu.pt = halfToFloat(getU16(p+1));
+        mu.e = halfToFloat(getU16(p+3));
+      }
+      else{
+        mu.pt = getFloat(p+1);
+        mu.e = getFloat(p+5);
+      }
+      const unsigned char* q = p + musize - 4;
+      mu.eta = decodeEta(static_cast<int16_t>(getU16(q)));
+      mu.phi = decodePhi(static_cast<int16_t>(getU16(q+2)));
+      pos += musize;
+    }
+    return pos;
+  }
+
+  //footer with the zone maps of all the row groups
+  inline void putFooter(std::vector<unsigned char>& out, uint64_t footerOffset,
+                        const std::vector<MuonZoneMap>& zoneMaps)
+  {
+    for(size_t i=0;i<zoneMaps.size();i++) putZoneMap(out, zoneMaps[i]);
+    putU64(out, footerOffset);
+    putU32(out, zoneMaps.size());
+    out.insert(out.end(), kFooterMagic, kFooterMagic+4);
+  }
+
+  //exact check of a decoded event against a selection
+  inline bool selectsEvent(const MuonZonePredicate& pred, const MuonBinaryEvent& evt)
+  {
+    if(!pred.matchesEvent(evt.run, evt.event, evt.muons.size())) return false;
+    if(!pred.hasMuonCut()) return true;
+    for(size_t j=0;j<evt.muons.size();j++){
+      if(pred.matchesMuon(evt.muons[j].pt, evt.muons[j].eta)) return true;
+    }
+    return false;
+  }
+
+  //Reader for MuonObjectInfo.bin that uses the zone maps in the footer
+  //to skip the row groups that cannot match a selection.
+  class MuonBinaryReader {
+  public:
+    MuonBinaryReader() : encoding_(0), groupsRead_(0) {}
+
+    //read the header and the footer; returns false on a bad file
+    bool open(const std::string& path)
+    {
+      zoneMaps_.clear();
+      groupsRead_ = 0;
+      file_.open(path.c_str(), std::ios::in|std::ios::binary);
+      if(!file_) return false;
+      unsigned char header[kBinaryHeaderSize];
+      if(!file_.read(reinterpret_cast<char*>(header), kBinaryHeaderSize)) return false;
+      if(!getBinaryHeader(header, kBinaryHeaderSize, encoding_)) return false;
+
+      file_.seekg(0, std::ios::end);
+      uint64_t fileSize = file_.tellg();
+      if(fileSize<kBinaryHeaderSize+kTrailerSize) return false;
+      unsigned char trailer[kTrailerSize];
+      file_.seekg(fileSize-kTrailerSize);
+      if(!file_.read(reinterpret_cast<char*>(trailer), kTrailerSize)) return false;
+      if(memcmp(trailer+12, kFooterMagic, 4)!=0) return false;
+      uint64_t footerOffset = getU64(trailer);
+      uint32_t nGroups = getU32(trailer+8);
+      if(footerOffset+nGroups*kZoneMapSize+kTrailerSize!=fileSize) return false;
+
+      std::vector<unsigned char> footer(nGroups*kZoneMapSize);
+      file_.seekg(footerOffset);
+      if(nGroups && !file_.read(reinterpret_cast<char*>(&footer[0]), footer.size())) return false;
+      zoneMaps_.resize(nGroups);
+      for(uint32_t i=0;i<nGroups;i++) getZoneMap(&footer[i*kZoneMapSize], zoneMaps_[i]);
+      return true;
+    }
+
+    uint8_t encoding() const { return encoding_; }
+    const std::vector<MuonZoneMap>& zoneMaps() const { return zoneMaps_; }
+    //number of row groups actually read from disk so far
+    size_t rowGroupsRead() const { return groupsRead_; }
+
+    //decode all the events of one row group (appended to events)
+    bool readRowGroup(size_t i, std::vector<MuonBinaryEvent>& events)
+    {
+      const MuonZoneMap& zm = zoneMaps_.at(i);
+      if(zm.nEvents==0) return true;
+      std::vector<unsigned char> buf(zm.size);
+      file_.clear();
+      file_.seekg(zm.offset);
+      if(!file_.read(reinterpret_cast<char*>(&buf[0]), buf.size())) return false;
+      ++groupsRead_;
+      DeltaCoder coder;
+      size_t pos = 0;
+      for(uint32_t k=0;k<zm.nEvents;k++){
+        MuonBinaryEvent evt;
+        size_t n = getEvent(&buf[0]+pos, buf.size()-pos, encoding_, coder, evt);
+        if(!n) return false;
+        pos += n;
+        events.push_back(evt);
+      }
+      return true;
+    }
+
+    //decode the event with the given number (e.g. the entry of
+    //MuonEventIndex), reading only its row group
+    bool readEvent(uint64_t entry, MuonBinaryEvent& evt)
+    {
+      //last row group starting at or before entry
+      size_t lo = 0, hi = zoneMaps_.size();
+      while(hi-lo>1){
+        size_t mid = (lo+hi)/2;
+        if(zoneMaps_[mid].firstEntry<=entry) lo = mid;
+        else hi = mid;
+      }
+      if(zoneMaps_.empty() || entry<zoneMaps_[lo].firstEntry ||
+         entry>=zoneMaps_[lo].firstEntry+zoneMaps_[lo].nEvents) return false;
+      std::vector<MuonBinaryEvent> group;
+      if(!readRowGroup(lo, group)) return false;
+      evt = group[entry-zoneMaps_[lo].firstEntry];
+      return true;
+    }
+
+    //decode only the events passing the selection, reading just
+    //the row groups whose zone map may match it
+    bool readSelected(const MuonZonePredicate& pred, std::vector<MuonBinaryEvent>& events)
+    {
+      std::vector<MuonBinaryEvent> group;
+      for(size_t i=0;i<zoneMaps_.size();i++){
+        if(!pred.mayMatch(zoneMaps_[i])) continue;
+        group.clear();
+        if(!readRowGroup(i, group)) return false;
+        for(size_t k=0;k<group.size();k++){
+          if(selectsEvent(pred, group[k])) events.push_back(group[k]);
+        }
+      }
+      return true;
+    }
+
+  private:
+    std::ifstream file_;
+    uint8_t encoding_;
+    std::vector<MuonZoneMap> zoneMaps_;
+    size_t groupsRead_;
+  };
+
+}
+
+#endif
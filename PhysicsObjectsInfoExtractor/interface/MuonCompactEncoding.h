@@ -0,0 +1,285 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonCompactEncoding_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonCompactEncoding_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MuonCompactEncoding.h
+//
+/**\file MuonCompactEncoding.h
+
+ Description: [Compact (bit-packed and quantized) encodings for muon columns]
+
+ Implementation:
+     Everything here is header-only and does not depend on CMSSW, so the
+     same functions can be used by the extractors (to write) and by any
+     standalone analysis code (to read back) the compact outputs.
+
+     Precision of the encodings:
+       - charge, isGlobal, isTracker: exact, packed in one byte of flags
+       - eta: 16-bit fixed point over [-8,8), step 2.44e-4,
+              max abs. error 1.22e-4 below 8-1.22e-4 (values above
+              that or below -8 are clamped)
+       - phi: 16-bit fixed point over [-pi,pi), step 9.59e-5,
+              max abs. error 4.8e-5
+       - pt, energy: IEEE 754 half float, max rel. error 2^-11 (4.9e-4)
+              in the normal range, clamped at 65504 GeV
+       - run, event: zig-zag delta to the previous value, stored as
+              a LEB128 varint (1 byte for consecutive events)
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+
+namespace muoncompact {
+
+  //bits used in the muon flags byte
+  const uint8_t kChargePositive = 0x1; //set if charge > 0
+  const uint8_t kHasCharge      = 0x2; //set if charge != 0
+  const uint8_t kIsGlobal       = 0x4;
+  const uint8_t kIsTracker      = 0x8;
+
+  //ranges and steps of the fixed point encodings
+  const double kEtaRange = 8.0;
+  const double kEtaStep  = 2.0*kEtaRange/65536.0;
+  const double kPhiStep  = 2.0*M_PI/65536.0;
+
+  //largest relative rounding error of a half float (normal range)
+  const double kHalfMaxRelError = 1.0/2048.0;
+  const float  kHalfMaxValue    = 65504.f;
+
+  // ------------ flags
+  inline uint8_t packFlags(int charge, bool isGlobal, bool isTracker)
+  {
+    uint8_t flags = 0;
+    if(charge>0) flags |= kChargePositive;
+    if(charge!=0) flags |= kHasCharge;
+    if(isGlobal) flags |= kIsGlobal;
+    if(isTracker) flags |= kIsTracker;
+    return flags;
+  }
+
+  inline int unpackCharge(uint8_t flags)
+  {
+    if(!(flags & kHasCharge)) return 0;
+    return (flags & kChargePositive) ? 1 : -1;
+  }
+
+  inline bool unpackIsGlobal(uint8_t flags) { return flags & kIsGlobal; }
+  inline bool unpackIsTracker(uint8_t flags) { return flags & kIsTracker; }
+
+  // ------------ 16-bit fixed point for eta and phi
+  inline int16_t quantize(double x, double step)
+  {
+    double q = std::floor(x/step + 0.5);
+    if(q>32767.) q = 32767.;
+    if(q<-32768.) q = -32768.;
+    return static_cast<int16_t>(q);
+  }
+
+  inline int16_t encodeEta(double eta) { return quantize(eta, kEtaStep); }
+  inline float decodeEta(int16_t q) { return q*kEtaStep; }
+
+  inline int16_t encodePhi(double phi)
+  {
+    //bring phi into [-pi,pi) and wrap the code so +pi and -pi are the same
+    while(phi>=M_PI) phi -= 2.0*M_PI;
+    while(phi<-M_PI) phi += 2.0*M_PI;
+    double q = std::floor(phi/kPhiStep + 0.5);
+    if(q>32767.) q -= 65536.;
+    return static_cast<int16_t>(q);
+  }
+  inline float decodePhi(int16_t q) { return q*kPhiStep; }
+
+  // ------------ half float (IEEE 754 binary16) for pt and energy
+  inline uint16_t floatToHalf(float value)
+  {
+    uint32_t f;
+    memcpy(&f, &value, sizeof(f));
+    uint16_t sign = (f >> 16) & 0x8000;
+    uint32_t absf = f & 0x7fffffff;
+
+    //NaN stays NaN
+    if(absf>0x7f800000) return sign | 0x7e00;
+    //too large (or infinite): clamp to the largest finite half
+    if(absf>=0x477ff000) return sign | 0x7bff;
+    //normal half range
+    if(absf>=0x38800000){
+      uint32_t mant = absf & 0x007fffff;
+      uint32_t exp = (absf >> 23) - 127 + 15;
+      uint32_t h = (exp << 10) | (mant >> 13);
+      //round to nearest even
+      uint32_t rest = mant & 0x1fff;
+      if(rest>0x1000 || (rest==0x1000 && (h & 1))) ++h;
+      return sign | h;
+    }
+    //subnormal half range
+    if(absf>=0x33000000){
+      uint32_t mant = (absf & 0x007fffff) | 0x00800000;
+      int shift = 126 - (absf >> 23);
+      uint32_t h = mant >> shift;
+      uint32_t rest = mant & ((1u << shift) - 1);
+      uint32_t half = 1u << (shift - 1);
+      if(rest>half || (rest==half && (h & 1))) ++h;
+      return sign | h;
+    }
+    return sign;
+  }
+
+  inline float halfToFloat(uint16_t h)
+  {
+    uint32_t sign = (h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+    uint32_t f;
+    if(exp==0x1f){
+      f = sign | 0x7f800000 | (mant << 13);
+    }
+    else if(exp!=0){
+      f = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+    }
+    else if(mant==0){
+      f = sign;
+    }
+    else{
+      //subnormal half: normalize it
+      exp = 127 - 15 + 1;
+      while(!(mant & 0x400)){ mant <<= 1; --exp; }
+      f = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+    }
+    float value;
+    memcpy(&value, &f, sizeof(value));
+    return value;
+  }
+
+  //true if a half float is good enough for the requested relative error
+  inline bool halfMeetsRelError(double maxRelError)
+  {
+    return maxRelError>=kHalfMaxRelError;
+  }
+
+  // ------------ zig-zag delta and varint for run and event numbers
+  inline uint64_t zigzag(int64_t v)
+  {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+  }
+
+  inline int64_t unzigzag(uint64_t v)
+  {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+  }
+
+  inline void putVarint(std::vector<unsigned char>& out, uint64_t v)
+  {
+    while(v>=0x80){
+      out.push_back(static_cast<unsigned char>(v | 0x80));
+      v >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(v));
+  }
+
+  //returns the number of bytes read, or 0 if the buffer ended too early
+  inline size_t getVarint(const unsigned char* in, size_t len, uint64_t& v)
+  {
+    v = 0;
+    for(size_t i=0;i<len && i<10;i++){
+      v |= static_cast<uint64_t>(in[i] & 0x7f) << (7*i);
+      if(!(in[i] & 0x80)) return i+1;
+    }
+    return 0;
+  }
+
+  // ------------ little endian fixed-width helpers
+  inline void putU16(std::vector<unsigned char>& out, uint16_t v)
+  {
+    out.push_back(v & 0xff);
+    out.push_back(v >> 8);
+  }
+
+  inline uint16_t getU16(const unsigned char* in)
+  {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+  }
+
+  inline void putU32(std::vector<unsigned char>& out, uint32_t v)
+  {
+    for(int i=0;i<4;i++) out.push_back((v >> (8*i)) & 0xff);
+  }
+
+  inline uint32_t getU32(const unsigned char* in)
+  {
+    uint32_t v = 0;
+    for(int i=0;i<4;i++) v |= static_cast<uint32_t>(in[i]) << (8*i);
+    return v;
+  }
+
+  inline void putU64(std::vector<unsigned char>& out, uint64_t v)
+  {
+    for(int i=0;i<8;i++) out.push_back((v >> (8*i)) & 0xff);
+  }
+
+  inline uint64_t getU64(const unsigned char* in)
+  {
+    uint64_t v = 0;
+    for(int i=0;i<8;i++) v |= static_cast<uint64_t>(in[i]) << (8*i);
+    return v;
+  }
+
+  inline void putFloat(std::vector<unsigned char>& out, float value)
+  {
+    uint32_t v;
+    memcpy(&v, &value, sizeof(v));
+    putU32(out, v);
+  }
+
+  inline float getFloat(const unsigned char* in)
+  {
+    uint32_t v = getU32(in);
+    float value;
+    memcpy(&value, &v, sizeof(value));
+    return value;
+  }
+
+  //Delta coder for the (run, event) pair of consecutive records.
+  //reset() must be called wherever a reader may start decoding.
+  class DeltaCoder {
+  public:
+    DeltaCoder() { reset(); }
+    void reset() { lastRun = 0; lastEvent = 0; }
+
+    void encode(std::vector<unsigned char>& out, uint64_t run, uint64_t event)
+    {
+      putVarint(out, zigzag(static_cast<int64_t>(run - lastRun)));
+      putVarint(out, zigzag(static_cast<int64_t>(event - lastEvent)));
+      lastRun = run;
+      lastEvent = event;
+    }
+
+    //returns the number of bytes read, or 0 on a truncated buffer
+    size_t decode(const unsigned char* in, size_t len, uint64_t& run, uint64_t& event)
+    {
+      uint64_t v;
+      size_t n1 = getVarint(in, len, v);
+      if(!n1) return 0;
+      run = lastRun + unzigzag(v);
+      size_t n2 = getVarint(in+n1, len-n1, v);
+      if(!n2) return 0;
+      event = lastEvent + unzigzag(v);
+      lastRun = run;
+      lastEvent = event;
+      return n1+n2;
+    }
+
+  private:
+    uint64_t lastRun;
+    uint64_t lastEvent;
+  };
+
+}
+
+#endif
@@ -0,0 +1,366 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonEventIndex_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonEventIndex_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MuonEventIndex.h
+//
+/**\file MuonEventIndex.h
+
+ Description: [Sorted (run, lumi, event) index written next to the extracted output]
+
+ Implementation:
+     The extractors collect one MuonEventIndexEntry per event and write them
+     at the end of the job, sorted by (run, event), into <output>.idx:
+
+       "MUIX", version (uint32), number of entries (uint64)
+       MuonEventIndexEntry[number of entries]   (48 bytes each)
+
+     The writer keeps at most maxInMemory entries in memory (fewer if
+     spill() is called, e.g. under memory pressure); the others are
+     sorted and spilled in runs to a temporary file, which write() merges.
+
+     The entries are written as they are in memory, so the whole file is
+     in the byte order of the machine that wrote it; open() rejects a file
+     with the other byte order, whose version would not read back right.
+     The file is mapped in memory as is, so a lookup is a binary search
+     over the mapped entries, O(log n), without reading the data itself.
+     Event numbers are unique within a run, so the lumi section is not
+     needed to look an event up, but it is kept in the entries.
+
+     nmu is the number of muons of the event.  What entry, offset and
+     muonOffset mean depends on the output:
+       ROOT (MuonObjectInfo.root.idx):
+               entry = entry number in mytree, offset = 0
+       binary (MuonObjectInfo.bin.idx):
+               entry = event number in the file, offset = byte offset of
+               its row group (see MuonBinaryReader::readEvent)
+       CSV, wide schema (MuonObjectInfo.csv.idx):
+               entry = row number, offset = byte offset of the event row
+               in MuonObjectInfo.csv
+       CSV, long schema (MuonObjectInfo_events.csv.idx):
+               entry = row number and offset = byte offset of the event
+               row in MuonObjectInfo_events.csv; muonOffset = byte offset
+               of its first row in MuonObjectInfo_muons.csv, followed by
+               its other nmu-1 muon rows
+     muonOffset is kNoMuonRows when the muons are not in a separate file,
+     or when the event has no muons.
+
+       MuonEventIndex index;
+       index.open("MuonObjectInfo.root.idx");
+       const MuonEventIndexEntry* e = index.find(run, event);
+       if(e) mytree->GetEntry(e->entry);
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MuonEventIndexEntry {
+  uint32_t run;
+  uint32_t lumi;
+  uint64_t event;
+  uint64_t entry;
+  uint64_t offset;
+  uint64_t muonOffset;
+  uint32_t nmu;
+  uint32_t pad;
+};
+
+static_assert(sizeof(MuonEventIndexEntry)==48, "MuonEventIndexEntry is stored as is");
+
+//muonOffset of the events whose muons are not in a separate file
+const uint64_t kNoMuonRows = ~0ULL;
+
+//the order of the index: (run, event), then lumi and entry for duplicates
+inline bool operator<(const MuonEventIndexEntry& a, const MuonEventIndexEntry& b)
+{
+  if(a.run!=b.run) return a.run<b.run;
+  if(a.event!=b.event) return a.event<b.event;
+  if(a.lumi!=b.lumi) return a.lumi<b.lumi;
+  return a.entry<b.entry;
+}
+
+const char kEventIndexMagic[4] = {'M','U','I','X'};
+const uint32_t kEventIndexVersion = 2;
+const size_t kEventIndexHeaderSize = 16;
+//entries kept in memory by the writer before it spills them (12 MB)
+const size_t kEventIndexMaxInMemory = 1<<18;
+//entries read at a time from each spilled run when merging
+const size_t kEventIndexMergeBuffer = 4096;
+
+// ------------ writer side, used by the extractors
+class MuonEventIndexWriter {
+ public:
+  explicit MuonEventIndexWriter(size_t maxInMemory = kEventIndexMaxInMemory)
+    : maxInMemory_(maxInMemory ? maxInMemory : 1), spillFile_(0), nSpilled_(0), failed_(false) {}
+  ~MuonEventIndexWriter() { clear(); }
+
+  //forget all the entries, also the spilled ones
+  void clear()
+  {
+    std::vector<MuonEventIndexEntry>().swap(entries_);
+    if(spillFile_) fclose(spillFile_);
+    spillFile_ = 0;
+    runs_.clear();
+    nSpilled_ = 0;
+    failed_ = false;
+  }
+
+  void add(uint32_t run, uint32_t lumi, uint64_t event, uint64_t entry, uint64_t offset,
+           uint32_t nmu, uint64_t muonOffset = kNoMuonRows)
+  {
+    MuonEventIndexEntry e;
+    e.run = run;
+    e.lumi = lumi;
+    e.event = event;
+    e.entry = entry;
+    e.offset = offset;
+    e.muonOffset = muonOffset;
+    e.nmu = nmu;
+    e.pad = 0;
+    //grow as a vector would, but never beyond maxInMemory_
+    if(entries_.size()==entries_.capacity()){
+      entries_.reserve(std::min(std::max<size_t>(2*entries_.size(), 64), maxInMemory_));
+    }
+    entries_.push_back(e);
+    if(entries_.size()>=maxInMemory_) writeRun();
+  }
+
+  //number of entries, in memory and spilled
+  uint64_t size() const { return nSpilled_+entries_.size(); }
+  //memory taken by the entries not spilled yet
+  size_t memoryBytes() const { return entries_.capacity()*sizeof(MuonEventIndexEntry); }
+  //number of sorted runs in the temporary file
+  size_t nRuns() const { return runs_.size(); }
+
+  //move the entries in memory to the temporary file and give their
+  //memory back; returns false if the file cannot be written
+  bool spill()
+  {
+    bool ok = writeRun();
+    std::vector<MuonEventIndexEntry>().swap(entries_);
+    return ok;
+  }
+
+  //sort the entries, merge them with the spilled runs and write the
+  //index file; returns false on failure
+  bool write(const std::string& path)
+  {
+    //once something is spilled, the rest goes to the file too, so that
+    //all the runs are merged the same way
+    if(!runs_.empty()) writeRun();
+    if(failed_) return false;
+    std::sort(entries_.begin(), entries_.end());
+    FILE* f = fopen(path.c_str(), "wb");
+    if(!f) return false;
+    unsigned char header[kEventIndexHeaderSize];
+    memcpy(header, kEventIndexMagic, 4);
+    uint32_t version = kEventIndexVersion;
+    uint64_t n = size();
+    memcpy(header+4, &version, 4);
+    memcpy(header+8, &n, 8);
+    bool ok = fwrite(header, 1, kEventIndexHeaderSize, f)==kEventIndexHeaderSize;
+    if(ok && runs_.empty()){
+      if(n) ok = fwrite(&entries_[0], sizeof(MuonEventIndexEntry), n, f)==n;
+    }
+    else if(ok) ok = merge(f);
+    ok = (fclose(f)==0) && ok;
+    return ok;
+  }
+
+ private:
+  //sort the entries in memory and append them as one run to the
+  //temporary file (created in the directory of tmpfile())
+  bool writeRun()
+  {
+    if(entries_.empty() || failed_) return !failed_;
+    if(!spillFile_) spillFile_ = tmpfile();
+    std::sort(entries_.begin(), entries_.end());
+    if(!spillFile_ || fseeko(spillFile_, 0, SEEK_END)!=0 ||
+       fwrite(&entries_[0], sizeof(MuonEventIndexEntry), entries_.size(), spillFile_)!=entries_.size()){
+      failed_ = true;
+      return false;
+    }
+    runs_.push_back(entries_.size());
+    nSpilled_ += entries_.size();
+    entries_.clear();
+    return true;
+  }
+
+  //one spilled run, read kEventIndexMergeBuffer entries at a time
+  struct Source {
+    std::vector<MuonEventIndexEntry> buf;
+    size_t pos;
+    off_t fileOffset; //of the next entries to read
+    uint64_t left;    //entries still in the file
+  };
+
+  //orders the sources by their current entry, smallest on top of the heap
+  struct LaterSource {
+    const std::vector<Source>* sources;
+    bool operator()(int a, int b) const
+    {
+      const Source& sa = (*sources)[a];
+      const Source& sb = (*sources)[b];
+      return sb.buf[sb.pos]<sa.buf[sa.pos];
+    }
+  };
+
+  bool refill(Source& src)
+  {
+    size_t k = std::min<uint64_t>(src.left, kEventIndexMergeBuffer);
+    src.buf.resize(k);
+    src.pos = 0;
+    if(k==0) return true;
+    if(fseeko(spillFile_, src.fileOffset, SEEK_SET)!=0 ||
+       fread(&src.buf[0], sizeof(MuonEventIndexEntry), k, spillFile_)!=k) return false;
+    src.fileOffset += k*sizeof(MuonEventIndexEntry);
+    src.left -= k;
+    return true;
+  }
+
+  //k-way merge of the spilled runs into f
+  bool merge(FILE* f)
+  {
+    std::vector<Source> sources(runs_.size());
+    off_t offset = 0;
+    for(size_t r=0;r<runs_.size();r++){
+      sources[r].fileOffset = offset;
+      sources[r].left = runs_[r];
+      offset += runs_[r]*sizeof(MuonEventIndexEntry);
+      if(!refill(sources[r])) return false;
+    }
+
+    LaterSource later;
+    later.sources = &sources;
+    std::vector<int> heap;
+    for(size_t r=0;r<sources.size();r++) if(!sources[r].buf.empty()) heap.push_back(r);
+    std::make_heap(heap.begin(), heap.end(), later);
+    std::vector<MuonEventIndexEntry> out;
+    out.reserve(kEventIndexMergeBuffer);
+    while(!heap.empty()){
+      std::pop_heap(heap.begin(), heap.end(), later);
+      Source& src = sources[heap.back()];
+      out.push_back(src.buf[src.pos++]);
+      if(src.pos==src.buf.size() && !refill(src)) return false;
+      if(src.buf.empty()) heap.pop_back();
+      else std::push_heap(heap.begin(), heap.end(), later);
+      if(out.size()==kEventIndexMergeBuffer || heap.empty()){
+        if(fwrite(&out[0], sizeof(MuonEventIndexEntry), out.size(), f)!=out.size()) return false;
+        out.clear();
+      }
+    }
+    return true;
+  }
+
+  MuonEventIndexWriter(const MuonEventIndexWriter&);
+  MuonEventIndexWriter& operator=(const MuonEventIndexWriter&);
+
+  size_t maxInMemory_;
+  std::vector<MuonEventIndexEntry> entries_;
+  FILE* spillFile_;              //sorted runs, removed when closed
+  std::vector<uint64_t> runs_;   //length of each run, in file order
+  uint64_t nSpilled_;
+  bool failed_;
+};
+
+// ------------ reader side: memory-mapped lookups
+class MuonEventIndex {
+ public:
+  MuonEventIndex() : map_(0), size_(0), entries_(0), n_(0) {}
+  ~MuonEventIndex() { close(); }
+
+  //map the index file; returns false if it is missing or not valid
+  bool open(const std::string& path)
+  {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd<0) return false;
+    struct stat st;
+    if(fstat(fd, &st)!=0 || static_cast<size_t>(st.st_size)<kEventIndexHeaderSize){ ::close(fd); return false; }
+    size_ = st.st_size;
+    void* p = mmap(0, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(p==MAP_FAILED) return false;
+    map_ = p;
+    const unsigned char* header = static_cast<const unsigned char*>(p);
+    uint32_t version;
+    uint64_t n;
+    memcpy(&version, header+4, 4);
+    memcpy(&n, header+8, 8);
+    if(memcmp(header, kEventIndexMagic, 4)!=0 || version!=kEventIndexVersion ||
+       size_!=kEventIndexHeaderSize+n*sizeof(MuonEventIndexEntry)){
+      close();
+      return false;
+    }
+    entries_ = reinterpret_cast<const MuonEventIndexEntry*>(header+kEventIndexHeaderSize);
+    n_ = n;
+    return true;
+  }
+
+  size_t size() const { return n_; }
+  const MuonEventIndexEntry* begin() const { return entries_; }
+  const MuonEventIndexEntry* end() const { return entries_+n_; }
+
+  //first entry for (run, event), or 0 if the event is not in the output
+  const MuonEventIndexEntry* find(uint32_t run, uint64_t event) const
+  {
+    const MuonEventIndexEntry* it = lowerBound(run, event);
+    if(it==end() || it->run!=run || it->event!=event) return 0;
+    return it;
+  }
+
+  //same, also requiring the lumi section
+  const MuonEventIndexEntry* find(uint32_t run, uint32_t lumi, uint64_t event) const
+  {
+    for(const MuonEventIndexEntry* it = lowerBound(run, event);
+        it!=end() && it->run==run && it->event==event; ++it){
+      if(it->lumi==lumi) return it;
+    }
+    return 0;
+  }
+
+  void close()
+  {
+    if(map_) munmap(map_, size_);
+    map_ = 0;
+    entries_ = 0;
+    n_ = 0;
+  }
+
+ private:
+  const MuonEventIndexEntry* lowerBound(uint32_t run, uint64_t event) const
+  {
+    MuonEventIndexEntry key;
+    key.run = run;
+    key.lumi = 0;
+    key.event = event;
+    key.entry = 0;
+    key.offset = 0;
+    key.muonOffset = 0;
+    key.nmu = 0;
+    key.pad = 0;
+    return std::lower_bound(begin(), end(), key);
+  }
+
+  void* map_;
+  size_t size_;
+  const MuonEventIndexEntry* entries_;
+  size_t n_;
+};
+
+#endif
@@ -0,0 +1,480 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonShmRing_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonShmRing_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MuonShmRing.h
+//
+/**\file MuonShmRing.h
+
+ Description: [Shared-memory ring buffer of fixed-layout muon event records]
+
+ Implementation:
+     One producer (MuonObjectInfoExtractorToShm) and up to kShmMaxConsumers
+     consumers on the same node share a POSIX shared-memory segment:
+
+       MuonShmHeader | MuonShmSlot[capacity]
+
+     Record n goes into slot n % capacity.  Each slot carries a sequence
+     number (a seqlock): 2n+1 while record n is being written and 2n+2
+     once it is complete, so consumers never take a lock and read the
+     record in place (no copy, no parsing).  A consumer does
+
+       muoncompact::MuonShmConsumer consumer;
+       while(!consumer.open("/MuonObjectInfo")) sleep(1);
+       while(...){
+         const muoncompact::MuonShmRecord* rec = consumer.peek();
+         if(!rec){
+           //all read; if the job is over (or died), wait for the next one,
+           //which creates a new segment under the same name
+           if(!consumer.producerAlive()){
+             consumer.close();
+             while(!consumer.open("/MuonObjectInfo")) sleep(1);
+           }
+           usleep(1000);
+           continue;
+         }
+         //... use rec->run, rec->muons[j].pt, ...
+         if(!consumer.release()){ //overwritten while reading, discard it
+         }
+       }
+
+     A consumer keeps the mapping of the segment it opened, so it does not
+     see a new job on its own: once the producer has closed the segment
+     (or its process is gone), producerAlive() is false and the consumer
+     has to open the name again.
+
+     What happens when a consumer falls behind by a full ring is set by
+     the producer policy:
+       kShmDrop:  the producer overwrites the oldest records; the slow
+                  consumer skips ahead and counts the records it lost.
+       kShmBlock: the producer waits (up to a timeout) for the slowest
+                  consumer.  On timeout that consumer is evicted, so a
+                  dead consumer cannot stall the extraction; when it
+                  comes back it re-registers and counts what it lost.
+
+     Each consumer slot belongs to one consumer, identified by an owner
+     token (its pid and a generation number), from the moment it is
+     claimed until that consumer closes.  Eviction only marks the slot
+     (state 3), it never hands it to another consumer, so an evicted
+     consumer cannot write into a cursor someone else is using; it
+     rejoins at the head through the same slot.  Slots whose owner
+     process is gone are reclaimed when no free slot is left.
+
+     create() refuses to take over a segment whose producer is still
+     running, so two jobs on the same node need different shmName.
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+//
+
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//the atomics below are shared between processes, which only works
+//if they are lock-free (and hence address-free)
+#if defined(ATOMIC_INT_LOCK_FREE) && defined(ATOMIC_LONG_LOCK_FREE)
+static_assert(ATOMIC_INT_LOCK_FREE==2 && ATOMIC_LONG_LOCK_FREE==2,
+              "MuonShmRing needs lock-free 32 and 64 bit atomics");
+#endif
+
+namespace muoncompact {
+
+  const uint32_t kShmMagic = 0x4d55534d; //"MUSM"
+  const uint32_t kShmVersion = 3;
+  const uint32_t kShmMaxMuons = 16;
+  const uint32_t kShmMaxConsumers = 16;
+
+  enum MuonShmPolicy { kShmDrop = 0, kShmBlock = 1 };
+
+  struct MuonShmMuon {
+    float e, pt, px, py, pz, eta, phi;
+    int8_t charge;
+    uint8_t flags; //isGlobal/isTracker bits, see MuonCompactEncoding.h
+    uint8_t pad[2];
+  };
+
+  struct MuonShmRecord {
+    uint32_t run;
+    uint32_t lumi;
+    uint64_t event;
+    uint32_t nmu;      //muons stored below (at most kShmMaxMuons)
+    uint32_t nmuTotal; //muons in the event
+    MuonShmMuon muons[kShmMaxMuons];
+  };
+
+  struct MuonShmSlot {
+    std::atomic<uint64_t> seq;
+    MuonShmRecord record;
+  };
+
+  //consumer slot states
+  enum MuonShmConsumerStatus {
+    kShmFree = 0,    //nobody owns the slot
+    kShmActive = 1,  //the owner is reading, the producer watches its cursor
+    kShmJoining = 2, //claimed, the cursor is being set
+    kShmEvicted = 3  //the owner was too slow; still owned, ignored by the producer
+  };
+
+  struct MuonShmConsumerState {
+    std::atomic<uint32_t> active; //a MuonShmConsumerStatus
+    uint32_t pad;
+    std::atomic<uint64_t> owner;  //pid<<32 | generation of the owner
+    std::atomic<uint64_t> next;   //next record the consumer will read
+  };
+
+  struct MuonShmHeader {
+    std::atomic<uint32_t> magic; //set last, once the segment is ready
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t policy;
+    uint64_t slotSize;
+    uint32_t producerPid;
+    std::atomic<uint32_t> generation; //last owner generation handed out
+    std::atomic<uint32_t> closed;     //set by the producer at the end of the job
+    std::atomic<uint64_t> head;    //number of records published
+    std::atomic<uint64_t> evicted; //consumers evicted for being too slow
+    MuonShmConsumerState consumers[kShmMaxConsumers];
+  };
+
+  inline size_t shmSegmentSize(uint32_t capacity)
+  {
+    return sizeof(MuonShmHeader) + capacity*sizeof(MuonShmSlot);
+  }
+
+  inline MuonShmSlot* shmSlots(MuonShmHeader* header)
+  {
+    return reinterpret_cast<MuonShmSlot*>(header+1);
+  }
+
+  //true if the process is known to be gone
+  inline bool shmProcessGone(uint32_t pid)
+  {
+    return pid==0 || (kill(pid, 0)!=0 && errno==ESRCH);
+  }
+
+  // ------------ writer side, used by the extractor
+  class MuonShmProducer {
+  public:
+    MuonShmProducer() : header_(0), size_(0), timeoutUs_(0), current_(0) {}
+    ~MuonShmProducer() { close(); }
+
+    //create the segment; returns false on failure (see error()).
+    //A segment left behind by a producer that is gone is replaced,
+    //one whose producer is still running is not.
+    bool create(const std::string& name, uint32_t capacity, MuonShmPolicy policy, uint32_t timeoutMs)
+    {
+      error_.clear();
+      if(capacity==0){ error_ = "the ring capacity must be positive"; return false; }
+      name_ = name;
+      timeoutUs_ = 1000ULL*timeoutMs;
+      int fd = shm_open(name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0644);
+      if(fd<0 && errno==EEXIST && staleSegment(name)){
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0644);
+      }
+      if(fd<0){
+        if(errno==EEXIST) error_ = "the name is in use by another running producer (or an incompatible segment), use another shmName";
+        else error_ = strerror(errno);
+        return false;
+      }
+      size_ = shmSegmentSize(capacity);
+      if(ftruncate(fd, size_)!=0){
+        error_ = strerror(errno);
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+      }
+      void* p = mmap(0, size_, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if(p==MAP_FAILED){
+        error_ = strerror(errno);
+        shm_unlink(name.c_str());
+        return false;
+      }
+      //the new segment is zero-filled, which is a valid initial state
+      //for all the (lock-free) atomics in it
+      header_ = static_cast<MuonShmHeader*>(p);
+      if(!header_->head.is_lock_free() || !header_->magic.is_lock_free()){
+        error_ = "the atomics are not lock-free on this platform";
+        close();
+        return false;
+      }
+      header_->producerPid = getpid();
+      header_->version = kShmVersion;
+      header_->capacity = capacity;
+      header_->policy = policy;
+      header_->slotSize = sizeof(MuonShmSlot);
+      header_->magic.store(kShmMagic, std::memory_order_release);
+      return true;
+    }
+
+    //slot where the next record should be written in place.
+    //Must be followed by commit().
+    MuonShmRecord* begin()
+    {
+      uint64_t n = header_->head.load(std::memory_order_relaxed);
+      if(header_->policy==kShmBlock) waitForConsumers(n);
+      current_ = &shmSlots(header_)[n % header_->capacity];
+      current_->seq.store(2*n+1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      return &current_->record;
+    }
+
+    //publish the record returned by begin()
+    void commit()
+    {
+      uint64_t n = header_->head.load(std::memory_order_relaxed);
+      current_->seq.store(2*n+2, std::memory_order_release);
+      header_->head.store(n+1, std::memory_order_release);
+      current_ = 0;
+    }
+
+    uint64_t published() const { return header_ ? header_->head.load() : 0; }
+    uint64_t evicted() const { return header_ ? header_->evicted.load() : 0; }
+    //why create() failed
+    const std::string& error() const { return error_; }
+
+    //unmap and remove the name; consumers still attached keep their
+    //mapping, and see producerAlive() turn false
+    void close()
+    {
+      if(!header_) return;
+      header_->closed.store(1, std::memory_order_release);
+      munmap(header_, size_);
+      shm_unlink(name_.c_str());
+      header_ = 0;
+    }
+
+  private:
+    //true if name is one of our segments and its producer is gone
+    static bool staleSegment(const std::string& name)
+    {
+      int fd = shm_open(name.c_str(), O_RDONLY, 0);
+      if(fd<0) return false;
+      struct stat st;
+      bool stale = false;
+      if(fstat(fd, &st)==0 && static_cast<size_t>(st.st_size)>=sizeof(MuonShmHeader)){
+        void* p = mmap(0, sizeof(MuonShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+        if(p!=MAP_FAILED){
+          const MuonShmHeader* h = static_cast<const MuonShmHeader*>(p);
+          stale = h->magic.load(std::memory_order_acquire)==kShmMagic && h->version==kShmVersion &&
+                  shmProcessGone(h->producerPid);
+          munmap(p, sizeof(MuonShmHeader));
+        }
+      }
+      ::close(fd);
+      return stale;
+    }
+
+    //wait until record n would not overwrite a record that an active
+    //consumer has not read yet.  On timeout, the consumers still in the
+    //way are evicted.
+    void waitForConsumers(uint64_t n)
+    {
+      uint64_t cap = header_->capacity;
+      if(n<cap) return;
+      uint64_t waited = 0;
+      while(true){
+        bool blocked = false;
+        for(uint32_t c=0;c<kShmMaxConsumers;c++){
+          MuonShmConsumerState& cs = header_->consumers[c];
+          if(cs.active.load(std::memory_order_acquire)==kShmActive &&
+             cs.next.load(std::memory_order_acquire)+cap<=n) blocked = true;
+        }
+        if(!blocked) return;
+        if(waited>=timeoutUs_) break;
+        usleep(50);
+        waited += 50;
+      }
+      //the slot stays with its owner, which rejoins at the head
+      for(uint32_t c=0;c<kShmMaxConsumers;c++){
+        MuonShmConsumerState& cs = header_->consumers[c];
+        uint32_t expected = kShmActive;
+        if(cs.next.load(std::memory_order_acquire)+cap<=n &&
+           cs.active.compare_exchange_strong(expected, kShmEvicted)){
+          header_->evicted.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    std::string name_;
+    std::string error_;
+    MuonShmHeader* header_;
+    size_t size_;
+    uint64_t timeoutUs_;
+    MuonShmSlot* current_;
+  };
+
+  // ------------ reader side, for the monitoring processes
+  class MuonShmConsumer {
+  public:
+    MuonShmConsumer() : header_(0), size_(0), id_(-1), token_(0), next_(0), lost_(0) {}
+    ~MuonShmConsumer() { close(); }
+
+    //attach to the segment and start from the newest record;
+    //returns false if there is no (valid) segment or no free consumer slot
+    bool open(const std::string& name)
+    {
+      int fd = shm_open(name.c_str(), O_RDWR, 0);
+      if(fd<0) return false;
+      struct stat st;
+      if(fstat(fd, &st)!=0 || static_cast<size_t>(st.st_size)<sizeof(MuonShmHeader)){ ::close(fd); return false; }
+      size_ = st.st_size;
+      void* p = mmap(0, size_, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if(p==MAP_FAILED) return false;
+      header_ = static_cast<MuonShmHeader*>(p);
+      if(header_->magic.load(std::memory_order_acquire)!=kShmMagic || header_->version!=kShmVersion ||
+         header_->slotSize!=sizeof(MuonShmSlot) || size_<shmSegmentSize(header_->capacity)){
+        close();
+        return false;
+      }
+      if(!header_->head.is_lock_free()){ close(); return false; }
+      if(!attach()){ close(); return false; }
+      return true;
+    }
+
+    //next record, read in place, or 0 if there is none yet.
+    //The pointer is valid until release() is called.
+    const MuonShmRecord* peek()
+    {
+      if(!header_) return 0;
+      //evicted by the producer for being too slow (or the slot was
+      //lost): join again at the head
+      if(!owns() || header_->consumers[id_].active.load(std::memory_order_acquire)!=kShmActive){
+        uint64_t oldNext = next_;
+        if(!attach()) return 0;
+        if(next_>oldNext) lost_ += next_-oldNext;
+      }
+      uint64_t cap = header_->capacity;
+      while(true){
+        MuonShmSlot& slot = shmSlots(header_)[next_ % cap];
+        uint64_t s = slot.seq.load(std::memory_order_acquire);
+        if(s==2*next_+2) return &slot.record;
+        if(s<2*next_+2) return 0; //not written yet
+        //the producer has lapped us: skip to the oldest record still there
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        uint64_t oldest = head>cap ? head-cap+1 : 0;
+        if(oldest<=next_) oldest = next_+1;
+        lost_ += oldest-next_;
+        setNext(oldest);
+      }
+    }
+
+    //done with the record returned by peek(); false if the producer
+    //overwrote it in the meantime, so what was read must be discarded
+    bool release()
+    {
+      if(!header_ || id_<0) return false;
+      MuonShmSlot& slot = shmSlots(header_)[next_ % header_->capacity];
+      std::atomic_thread_fence(std::memory_order_acquire);
+      bool valid = slot.seq.load(std::memory_order_relaxed)==2*next_+2;
+      if(!valid) ++lost_;
+      setNext(next_+1);
+      return valid;
+    }
+
+    //records published but never seen by this consumer
+    uint64_t lost() const { return lost_; }
+
+    //false once the producer has closed the segment or its process is
+    //gone: no more records will come, the name has to be opened again
+    bool producerAlive() const
+    {
+      return header_ && !header_->closed.load(std::memory_order_acquire) &&
+             !shmProcessGone(header_->producerPid);
+    }
+
+    void close()
+    {
+      if(!header_) return;
+      if(owns()) header_->consumers[id_].active.store(kShmFree, std::memory_order_release);
+      munmap(header_, size_);
+      header_ = 0;
+      id_ = -1;
+    }
+
+  private:
+    //true if the slot id_ is still ours.  Only its owner frees a slot
+    //and only slots of dead owners are reclaimed, so once this is true
+    //it stays true while we are running.
+    bool owns() const
+    {
+      return header_ && id_>=0 &&
+             header_->consumers[id_].owner.load(std::memory_order_acquire)==token_;
+    }
+
+    //(re)join at the head: through our own slot after an eviction,
+    //otherwise by claiming a free slot, or one whose owner is gone
+    bool attach()
+    {
+      if(owns()){
+        uint32_t expected = kShmEvicted;
+        MuonShmConsumerState& cs = header_->consumers[id_];
+        if(cs.active.compare_exchange_strong(expected, kShmJoining)) return join(cs);
+        if(expected==kShmActive) return true;
+      }
+      id_ = -1;
+      for(int pass=0;pass<2;pass++){
+        for(uint32_t c=0;c<kShmMaxConsumers;c++){
+          MuonShmConsumerState& cs = header_->consumers[c];
+          uint32_t expected = cs.active.load(std::memory_order_acquire);
+          if(pass==0 && expected!=kShmFree) continue;
+          if(pass==1 && (expected==kShmFree || expected==kShmJoining ||
+                         !shmProcessGone(cs.owner.load(std::memory_order_acquire)>>32))) continue;
+          //claim the slot as joining, which the producer ignores, and
+          //only become active once the owner and the cursor are set
+          if(cs.active.compare_exchange_strong(expected, kShmJoining)){
+            id_ = c;
+            uint64_t gen = header_->generation.fetch_add(1, std::memory_order_relaxed)+1;
+            token_ = (static_cast<uint64_t>(getpid())<<32) | (gen & 0xffffffffULL);
+            cs.owner.store(token_, std::memory_order_release);
+            return join(cs);
+          }
+        }
+      }
+      return false;
+    }
+
+    bool join(MuonShmConsumerState& cs)
+    {
+      setNext(header_->head.load(std::memory_order_acquire));
+      cs.active.store(kShmActive, std::memory_order_release);
+      return true;
+    }
+
+    //move the cursor; the shared copy is only written through a slot
+    //we own, otherwise the next peek() attaches again
+    void setNext(uint64_t n)
+    {
+      next_ = n;
+      if(!owns()){
+        id_ = -1;
+        return;
+      }
+      header_->consumers[id_].next.store(n, std::memory_order_release);
+    }
+
+    MuonShmHeader* header_;
+    size_t size_;
+    int id_;
+    uint64_t token_;
+    uint64_t next_;
+    uint64_t lost_;
+  };
+
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonZoneMap_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonZoneMap_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MuonZoneMap.h
+//
+/**\file MuonZoneMap.h
+
+ Description: [Per-chunk min/max statistics (zone maps) of the extracted muons]
+
+ Implementation:
+     The writers keep one MuonZoneMap per chunk of events (a range of
+     TTree entries or a binary row group).  A reader can then check a selection with
+     MuonZonePredicate::mayMatch() and skip the chunks that cannot contain
+     any selected event, without reading them.  The check is conservative:
+     a chunk that passes may still have no selected event.
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonCompactEncoding.h"
+
+#include <float.h>
+#include <limits.h>
+#include <vector>
+
+namespace muoncompact {
+
+  struct MuonZoneMap {
+    uint64_t offset;     //byte offset of the chunk (binary only)
+    uint64_t size;       //size of the chunk in bytes (binary only)
+    uint64_t firstEntry; //number of the first event in the chunk
+    uint32_t nEvents;
+    //statistics of the muons in the chunk (min > max if there are none)
+    float ptMin, ptMax;
+    float etaMin, etaMax;
+    uint32_t nmuMin, nmuMax;
+    uint64_t runMin, runMax;
+    uint64_t eventMin, eventMax;
+
+    MuonZoneMap() { reset(0,0); }
+
+    void reset(uint64_t theOffset, uint64_t theFirstEntry)
+    {
+      offset = theOffset; size = 0;
+      firstEntry = theFirstEntry; nEvents = 0;
+      ptMin = FLT_MAX; ptMax = -FLT_MAX;
+      etaMin = FLT_MAX; etaMax = -FLT_MAX;
+      nmuMin = UINT_MAX; nmuMax = 0;
+      runMin = eventMin = ~0ULL;
+      runMax = eventMax = 0;
+    }
+
+    void fillEvent(uint64_t run, uint64_t event, uint32_t nmu)
+    {
+      ++nEvents;
+      if(nmu<nmuMin) nmuMin = nmu;
+      if(nmu>nmuMax) nmuMax = nmu;
+      if(run<runMin) runMin = run;
+      if(run>runMax) runMax = run;
+      if(event<eventMin) eventMin = event;
+      if(event>eventMax) eventMax = event;
+    }
+
+    void fillMuon(float pt, float eta)
+    {
+      if(pt<ptMin) ptMin = pt;
+      if(pt>ptMax) ptMax = pt;
+      if(eta<etaMin) etaMin = eta;
+      if(eta>etaMax) etaMax = eta;
+    }
+
+    bool hasMuons() const { return ptMin<=ptMax; }
+  };
+
+  //A selection on the muons/events.  The default one selects everything.
+  //The muon cuts mean "at least one muon with pt > ptMin and |eta| < absEtaMax".
+  struct MuonZonePredicate {
+    float ptMin;
+    float absEtaMax;
+    uint32_t nmuMin, nmuMax;
+    uint64_t runMin, runMax;
+    uint64_t eventMin, eventMax;
+
+    MuonZonePredicate()
+      : ptMin(-FLT_MAX), absEtaMax(FLT_MAX),
+        nmuMin(0), nmuMax(UINT_MAX),
+        runMin(0), runMax(~0ULL),
+        eventMin(0), eventMax(~0ULL) {}
+
+    bool hasMuonCut() const { return ptMin>-FLT_MAX || absEtaMax<FLT_MAX; }
+
+    //false only if no event of the chunk can pass the selection
+    bool mayMatch(const MuonZoneMap& zm) const
+    {
+      if(zm.nEvents==0) return false;
+      if(zm.nmuMax<nmuMin || zm.nmuMin>nmuMax) return false;
+      if(zm.runMax<runMin || zm.runMin>runMax) return false;
+      if(zm.eventMax<eventMin || zm.eventMin>eventMax) return false;
+      if(hasMuonCut()){
+        if(!zm.hasMuons()) return false;
+        if(zm.ptMax<=ptMin) return false;
+        if(zm.etaMin>=absEtaMax || zm.etaMax<=-absEtaMax) return false;
+      }
+      return true;
+    }
+
+    //exact check for one event, once the chunk has been read
+    bool matchesEvent(uint64_t run, uint64_t event, uint32_t nmu) const
+    {
+      return nmu>=nmuMin && nmu<=nmuMax && run>=runMin && run<=runMax
+        && event>=eventMin && event<=eventMax;
+    }
+
+    bool matchesMuon(float pt, float eta) const
+    {
+      return pt>ptMin && std::fabs(eta)<absEtaMax;
+    }
+  };
+
+  // ------------ serialization used by the binary footer
+  const size_t kZoneMapSize = 84;
+
+  inline void putZoneMap(std::vector<unsigned char>& out, const MuonZoneMap& zm)
+  {
+    putU64(out, zm.offset);
+    putU64(out, zm.size);
+    putU64(out, zm.firstEntry);
+    putU32(out, zm.nEvents);
+    putFloat(out, zm.ptMin);
+    putFloat(out, zm.ptMax);
+    putFloat(out, zm.etaMin);
+    putFloat(out, zm.etaMax);
+    putU32(out, zm.nmuMin);
+    putU32(out, zm.nmuMax);
+    putU64(out, zm.runMin);
+    putU64(out, zm.runMax);
+    putU64(out, zm.eventMin);
+    putU64(out, zm.eventMax);
+  }
+
+  inline void getZoneMap(const unsigned char* in, MuonZoneMap& zm)
+  {
+    zm.offset = getU64(in);
+    zm.size = getU64(in+8);
+    zm.firstEntry = getU64(in+16);
+    zm.nEvents = getU32(in+24);
+    zm.ptMin = getFloat(in+28);
+    zm.ptMax = getFloat(in+32);
+    zm.etaMin = getFloat(in+36);
+    zm.etaMax = getFloat(in+40);
+    zm.nmuMin = getU32(in+44);
+    zm.nmuMax = getU32(in+48);
+    zm.runMin = getU64(in+52);
+    zm.runMax = getU64(in+60);
+    zm.eventMin = getU64(in+68);
+    zm.eventMax = getU64(in+76);
+  }
+
+}
+
+#endif
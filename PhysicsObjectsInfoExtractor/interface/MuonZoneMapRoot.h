@@ -0,0 +1,102 @@
+#ifndef PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonZoneMapRoot_h
+#define PhysicsObjectsInfo_PhysicsObjectsInfoExtractor_MuonZoneMapRoot_h
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       MuonZoneMapRoot.h
+//
+/**\file MuonZoneMapRoot.h
+
+ Description: [Zone maps stored next to the muon tree in MuonObjectInfo.root]
+
+ Implementation:
+     The writer fills one entry of the "zonemaps" tree per range of
+     entries of "mytree" (zoneMapChunkSize entries, fewer after a flush
+     forced by the memory budget).  A reader would do something like:
+
+       TTree* zonetree = (TTree*)file->Get("zonemaps");
+       std::vector<muoncompact::MuonZoneMap> zoneMaps;
+       muoncompact::readZoneMaps(zonetree, zoneMaps);
+       muoncompact::MuonZonePredicate pred;
+       pred.ptMin = 20; pred.absEtaMax = 2.1;
+       std::vector<std::pair<Long64_t,Long64_t> > ranges;
+       muoncompact::selectEntryRanges(zoneMaps, pred, ranges);
+       //and then only loop over mytree entries in [first,last) of each range
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonZoneMap.h"
+
+#include "TTree.h"
+
+#include <utility>
+#include <vector>
+
+namespace muoncompact {
+
+  //create (writer) the zone map branches pointing to zm
+  inline void branchZoneMap(TTree* zonetree, MuonZoneMap& zm)
+  {
+    zonetree->Branch("firstEntry",&zm.firstEntry,"firstEntry/l");
+    zonetree->Branch("nEvents",&zm.nEvents,"nEvents/i");
+    zonetree->Branch("ptMin",&zm.ptMin,"ptMin/F");
+    zonetree->Branch("ptMax",&zm.ptMax,"ptMax/F");
+    zonetree->Branch("etaMin",&zm.etaMin,"etaMin/F");
+    zonetree->Branch("etaMax",&zm.etaMax,"etaMax/F");
+    zonetree->Branch("nmuMin",&zm.nmuMin,"nmuMin/i");
+    zonetree->Branch("nmuMax",&zm.nmuMax,"nmuMax/i");
+    zonetree->Branch("runMin",&zm.runMin,"runMin/l");
+    zonetree->Branch("runMax",&zm.runMax,"runMax/l");
+    zonetree->Branch("eventMin",&zm.eventMin,"eventMin/l");
+    zonetree->Branch("eventMax",&zm.eventMax,"eventMax/l");
+  }
+
+  //read back (reader) all the zone maps of the tree
+  inline bool readZoneMaps(TTree* zonetree, std::vector<MuonZoneMap>& zoneMaps)
+  {
+    if(!zonetree) return false;
+    //uint64_t is not always ULong64_t, hence the void* for those branches
+    MuonZoneMap zm;
+    zonetree->SetBranchAddress("firstEntry",(void*)&zm.firstEntry);
+    zonetree->SetBranchAddress("nEvents",&zm.nEvents);
+    zonetree->SetBranchAddress("ptMin",&zm.ptMin);
+    zonetree->SetBranchAddress("ptMax",&zm.ptMax);
+    zonetree->SetBranchAddress("etaMin",&zm.etaMin);
+    zonetree->SetBranchAddress("etaMax",&zm.etaMax);
+    zonetree->SetBranchAddress("nmuMin",&zm.nmuMin);
+    zonetree->SetBranchAddress("nmuMax",&zm.nmuMax);
+    zonetree->SetBranchAddress("runMin",(void*)&zm.runMin);
+    zonetree->SetBranchAddress("runMax",(void*)&zm.runMax);
+    zonetree->SetBranchAddress("eventMin",(void*)&zm.eventMin);
+    zonetree->SetBranchAddress("eventMax",(void*)&zm.eventMax);
+    zoneMaps.clear();
+    for(Long64_t i=0;i<zonetree->GetEntries();i++){
+      zonetree->GetEntry(i);
+      zoneMaps.push_back(zm);
+    }
+    zonetree->ResetBranchAddresses();
+    return true;
+  }
+
+  //entry ranges [first,last) of the muon tree that may pass the selection.
+  //Consecutive chunks are merged into a single range.
+  inline void selectEntryRanges(const std::vector<MuonZoneMap>& zoneMaps, const MuonZonePredicate& pred,
+                                std::vector<std::pair<Long64_t,Long64_t> >& ranges)
+  {
+    ranges.clear();
+    for(size_t i=0;i<zoneMaps.size();i++){
+      const MuonZoneMap& zm = zoneMaps[i];
+      if(!pred.mayMatch(zm)) continue;
+      Long64_t first = zm.firstEntry;
+      Long64_t last = first + zm.nEvents;
+      if(!ranges.empty() && ranges.back().second==first) ranges.back().second = last;
+      else ranges.push_back(std::make_pair(first,last));
+    }
+  }
+
+}
+
+#endif
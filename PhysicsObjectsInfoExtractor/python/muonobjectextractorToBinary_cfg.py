@@ -0,0 +1,26 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("muonexttobin")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(100) )
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+'root://eospublic.cern.ch//eos/opendata/cms/Run2011A/DoubleMu/AOD/12Oct2013-v1/10000/000D143E-9535-E311-B88B-002618943934.root',
+        'root://eospublic.cern.ch//eos/opendata/cms/Run2011A/ElectronHad/AOD/12Oct2013-v1/20001/001F9231-F141-E311-8F76-003048F00942.root'
+    )
+)
+
+process.muonextractorToBinary = cms.EDAnalyzer('MuonObjectInfoExtractorToBinary',
+InputCollection = cms.InputTag("muons"),
+ptEnergyMaxRelError = cms.untracked.double(1e-3),#half floats are used if >= 4.9e-4
+rowGroupSize = cms.untracked.uint32(1000),#events per row group (and zone map), must be positive
+memoryBudgetMB = cms.untracked.double(0),#0 = no memory budget
+memoryCheckInterval = cms.untracked.uint32(100),
+writeEventIndex = cms.untracked.bool(True)#write MuonObjectInfo.bin.idx
+)
+
+
+process.p = cms.Path(process.muonextractorToBinary)
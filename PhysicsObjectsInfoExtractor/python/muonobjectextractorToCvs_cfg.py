@@ -15,7 +15,11 @@ process.source = cms.Source("PoolSource",
 
 process.muonextractorToCsv = cms.EDAnalyzer('MuonObjectInfoExtractorToCsv',
 InputCollection = cms.InputTag("muons"),
-maxNumberMuons = cms.untracked.int32(10)#default is 5
+maxNumberMuons = cms.untracked.int32(10),#default is 5
+#"wide": one row per event with maxNumberMuons slots (default)
+#"long": one row per muon (MuonObjectInfo_muons.csv) plus one per event (MuonObjectInfo_events.csv)
+outputSchema = cms.untracked.string("wide"),
+writeEventIndex = cms.untracked.bool(True)#write the .idx file next to the csv
 )
 
 
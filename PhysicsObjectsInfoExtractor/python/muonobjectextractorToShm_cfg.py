@@ -0,0 +1,27 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("muonexttoshm")
+
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(100) )
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(
+'root://eospublic.cern.ch//eos/opendata/cms/Run2011A/DoubleMu/AOD/12Oct2013-v1/10000/000D143E-9535-E311-B88B-002618943934.root',
+        'root://eospublic.cern.ch//eos/opendata/cms/Run2011A/ElectronHad/AOD/12Oct2013-v1/20001/001F9231-F141-E311-8F76-003048F00942.root'
+    )
+)
+
+process.muonextractorToShm = cms.EDAnalyzer('MuonObjectInfoExtractorToShm',
+InputCollection = cms.InputTag("muons"),
+shmName = cms.untracked.string("/MuonObjectInfo"),#must be unique among the running jobs of the node
+ringCapacity = cms.untracked.uint32(4096),#records kept in the ring
+#"drop": overwrite records slow consumers have not read yet
+#"block": wait for them up to blockTimeoutMs, then evict them
+slowConsumerPolicy = cms.untracked.string("drop"),
+blockTimeoutMs = cms.untracked.uint32(100)
+)
+
+
+process.p = cms.Path(process.muonextractorToShm)
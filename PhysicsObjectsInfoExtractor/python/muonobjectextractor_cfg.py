@@ -17,7 +17,23 @@ process.source = cms.Source("PoolSource",
 
 process.muonextractor = cms.EDAnalyzer('MuonObjectInfoExtractor',
 #change the input collection to other like cosmic muons, for instance
-InputCollection = cms.InputTag("muons")
+InputCollection = cms.InputTag("muons"),
+#store bit-packed/quantized branches instead of plain floats
+compactEncoding = cms.untracked.bool(False),
+#largest relative error allowed on the compact pt and energy: half floats
+#are used if it is >= 4.9e-4, 32-bit floats otherwise
+ptEnergyMaxRelError = cms.untracked.double(1e-3),
+#entries per zone map chunk and per tree cluster (SetAutoFlush), must be positive
+zoneMapChunkSize = cms.untracked.uint32(1000),
+#largest DeltaR to match a muon to its closest other muon
+matchDeltaRMax = cms.untracked.double(0.4),
+#memory budget of the job in MB (0 = none); close to it the tree is flushed
+#and smaller baskets/clusters are used, growing back once it is under 70% of the budget.
+#RSS is checked every memoryCheckInterval events
+memoryBudgetMB = cms.untracked.double(0),
+memoryCheckInterval = cms.untracked.uint32(100),
+#write MuonObjectInfo.root.idx, a sorted (run, lumi, event) -> entry index
+writeEventIndex = cms.untracked.bool(True)
 )
 
 
@@ -31,6 +31,8 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 //classes included to extract muon information
 #include "DataFormats/MuonReco/interface/Muon.h"
@@ -40,9 +42,21 @@
 #include "DataFormats/TrackReco/interface/Track.h"
 #include "DataFormats/TrackReco/interface/TrackFwd.h"
 
+//bit-packed and quantized encodings for the compact branches
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonCompactEncoding.h"
+//per-chunk statistics used by the readers to skip entry ranges
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonZoneMapRoot.h"
+//eta-phi grid for the DeltaR matching between objects
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/EtaPhiGrid.h"
+//watchdog for the memory budget of the job
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MemoryWatchdog.h"
+//(run, lumi, event) -> entry index written next to the root file
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonEventIndex.h"
+
 //additional classes for storage, containers and operations
 #include<vector>
 #include<string>
+#include<algorithm>
 #include "TFile.h"
 #include "TTree.h"
 #include <stdlib.h>
@@ -73,14 +87,48 @@ class MuonObjectInfoExtractor : public edm::EDAnalyzer {
  
  //declare a function to do the muon analysis
       void analyzeMuons(const edm::Event& iEvent);
+  //same as above but for the compact branches
+      void analyzeMuonsCompact(const edm::Event& iEvent);
+  //update the zone map with the event just filled, and store it
+  //once the chunk is complete
+      void fillZoneMap();
+      void closeZoneMapChunk();
+  //find, for each muon, the closest other muon in DeltaR
+      void matchMuons();
+  //flush the tree and use smaller buffers when close to the memory budget
+      void relieveMemoryPressure();
+      void growBuffers();
   //declare the input tag for the muons collection to be used (read from cofiguration)
   edm::InputTag muonsInput;
+  //store the compact (quantized) branches instead of plain floats
+  bool compactEncoding;
+  //largest relative error allowed on pt and energy in compact mode
+  double ptEnergyMaxRelError;
+  bool halfPtEnergy;
+  //number of entries per tree cluster and per zone map
+  unsigned int zoneMapChunkSize;
+  //largest DeltaR for two objects to be matched
+  double matchDeltaRMax;
+  EtaPhiGrid* matchGrid;
+  EtaPhiGrid* trackGrid;
+  //memory budget of the job (0 means no budget)
+  MemoryWatchdog* watchdog;
+  //current entries per cluster and basket size, both shrink under pressure
+  //and grow back up to zoneMapChunkSize and kBasketSize
+  unsigned int flushEntries;
+  int basketSize;
+  unsigned int nForcedFlushes;
+  //write MuonObjectInfo.root.idx to find events without scanning the tree
+  bool writeEventIndex;
+  MuonEventIndexWriter eventIndex;
   
   //These variable will be global
 
   //Declare some variables for storage
   TFile* myfile;//root file
   TTree* mytree;//root tree
+  TTree* zonetree;//tree with one zone map per entry range of mytree
+  muoncompact::MuonZoneMap zoneMap;
 
   //and declare variable that will go into the root tree
   int runno; //run number
@@ -97,6 +145,21 @@ class MuonObjectInfoExtractor : public edm::EDAnalyzer {
   std::vector<float> mu_glbtrk_pt;
   std::vector<float> mu_glbtrk_eta;
   std::vector<float> mu_glbtrk_phi;
+  //compact versions, only filled if compactEncoding is set
+  std::vector<unsigned char> mu_flags;
+  std::vector<unsigned short> mu_pt_h;
+  std::vector<unsigned short> mu_e_h;
+  std::vector<short> mu_eta_q;
+  std::vector<short> mu_phi_q;
+  std::vector<unsigned short> mu_glbtrk_pt_h;
+  std::vector<short> mu_glbtrk_eta_q;
+  std::vector<short> mu_glbtrk_phi_q;
+  //closest other muon within matchDeltaRMax (-1 and -999 if none)
+  std::vector<int> mu_nearmu_idx;
+  std::vector<float> mu_nearmu_dr;
+  //closest global track (of any muon) within matchDeltaRMax (-1 and -999 if none)
+  std::vector<int> mu_glbtrk_idx;
+  std::vector<float> mu_glbtrk_dr;
 
   
 
@@ -107,6 +170,12 @@ class MuonObjectInfoExtractor : public edm::EDAnalyzer {
 // constants, enums and typedefs
 //
 
+//smallest sizes the tree buffers are shrunk to under memory pressure
+static const int kMinBasketSize = 4000;
+//basket size outside of memory pressure (the ROOT default)
+static const int kBasketSize = 32000;
+static const unsigned int kMinFlushEntries = 10;
+
 //
 // static data member definitions
 //
@@ -119,6 +188,21 @@ MuonObjectInfoExtractor::MuonObjectInfoExtractor(const edm::ParameterSet& iConfi
 {
   //This should match the configuration in the corresponding python file
   muonsInput = iConfig.getParameter<edm::InputTag>("InputCollection");
+  compactEncoding = iConfig.getUntrackedParameter<bool>("compactEncoding",false);
+  ptEnergyMaxRelError = iConfig.getUntrackedParameter<double>("ptEnergyMaxRelError",1e-3);
+  zoneMapChunkSize = iConfig.getUntrackedParameter<unsigned int>("zoneMapChunkSize",1000);
+  if(zoneMapChunkSize==0){
+    throw cms::Exception("Configuration")<<"MuonObjectInfoExtractor: zoneMapChunkSize should be positive";
+  }
+  matchDeltaRMax = iConfig.getUntrackedParameter<double>("matchDeltaRMax",0.4);
+  if(matchDeltaRMax<=0){
+    throw cms::Exception("Configuration")<<"MuonObjectInfoExtractor: matchDeltaRMax should be positive";
+  }
+  matchGrid = new EtaPhiGrid(matchDeltaRMax);
+  trackGrid = new EtaPhiGrid(matchDeltaRMax);
+  writeEventIndex = iConfig.getUntrackedParameter<bool>("writeEventIndex",true);
+  watchdog = new MemoryWatchdog(iConfig.getUntrackedParameter<double>("memoryBudgetMB",0),
+                                iConfig.getUntrackedParameter<unsigned int>("memoryCheckInterval",100));
 
 }
 
@@ -128,6 +212,9 @@ MuonObjectInfoExtractor::~MuonObjectInfoExtractor()
  
    // do anything here that needs to be done at desctruction time
    // (e.g. close files, deallocate resources etc.)
+   delete matchGrid;
+   delete trackGrid;
+   delete watchdog;
 
 }
 
@@ -152,7 +239,9 @@ MuonObjectInfoExtractor::analyze(const edm::Event& iEvent, const edm::EventSetup
    //the event setup if it were needed.  For example, if you need to 
    //store the trigger information you will need to follow
    //this example (https://github.com/cms-opendata-analyses/trigger_examples/tree/master/TriggerInfo/TriggerInfoAnalyzer) and check how to do it.
-   analyzeMuons(iEvent);
+   if(compactEncoding) analyzeMuonsCompact(iEvent);
+   else analyzeMuons(iEvent);
+   matchMuons();
 
    //Here, if one were to write a more general PhysicsObjectsInfoExtractor.cc
    //code, this is where the rest of the objects extraction will be, for exmaple:
@@ -161,11 +250,20 @@ MuonObjectInfoExtractor::analyze(const edm::Event& iEvent, const edm::EventSetup
    //analyzeJets(iEvent, iSetup);
    //analyzeMet (iEvent, iSetup);
    //......
+   //Those objects could be matched to the muons the same way
+   //matchMuons() does, inserting them in an EtaPhiGrid.
 
   
 
    //fill the root tree
    mytree->Fill();
+   if(writeEventIndex){
+     eventIndex.add(iEvent.id().run(),iEvent.id().luminosityBlock(),iEvent.id().event(),mytree->GetEntries()-1,0,nmu);
+   }
+   fillZoneMap();
+   MemoryState memory = watchdog->check();
+   if(memory==kMemoryPressure) relieveMemoryPressure();
+   else if(memory==kMemoryRoom) growBuffers();
    return;
 
 }
@@ -261,6 +359,211 @@ MuonObjectInfoExtractor::analyzeMuons(const edm::Event& iEvent)
   
 }
 
+// ------------ function to analyze muons into the compact branches
+void 
+MuonObjectInfoExtractor::analyzeMuonsCompact(const edm::Event& iEvent)
+{
+  //clear the storage containers for this objects in this event
+  nmu=0;
+  mu_flags.clear();
+  mu_pt.clear();
+  mu_e.clear();
+  mu_pt_h.clear();
+  mu_e_h.clear();
+  mu_eta_q.clear();
+  mu_phi_q.clear();
+  mu_glbtrk_pt.clear();
+  mu_glbtrk_pt_h.clear();
+  mu_glbtrk_eta_q.clear();
+  mu_glbtrk_phi_q.clear();
+
+  //see analyzeMuons above for the details
+  edm::Handle<reco::MuonCollection> mymuons;
+  iEvent.getByLabel(muonsInput, mymuons); 
+
+  if(mymuons.isValid()){
+      nmu=(*mymuons).size();
+	for (reco::MuonCollection::const_iterator recoMu = mymuons->begin(); recoMu!=mymuons->end(); ++recoMu){
+	  //the global/tracker flags tell which muons are which,
+	  //so all muons keep their kinematics (no -999 placeholders).
+	  //px, py and pz are not stored: they follow from pt, eta and phi.
+	  mu_flags.push_back(muoncompact::packFlags(recoMu->charge(),recoMu->isGlobalMuon(),recoMu->isTrackerMuon()));
+	  if(halfPtEnergy){
+	    mu_pt_h.push_back(muoncompact::floatToHalf(recoMu->pt()));
+	    mu_e_h.push_back(muoncompact::floatToHalf(recoMu->energy()));
+	  }
+	  else{
+	    mu_pt.push_back(recoMu->pt());
+	    mu_e.push_back(recoMu->energy());
+	  }
+	  mu_eta_q.push_back(muoncompact::encodeEta(recoMu->eta()));
+	  mu_phi_q.push_back(muoncompact::encodePhi(recoMu->phi()));
+
+	  //the global track only exists for global muons, zeros otherwise
+	  float glbpt = 0, glbeta = 0, glbphi = 0;
+	  if(recoMu->isGlobalMuon()){
+	    reco::TrackRef recoCombinedGlbTrack = recoMu->combinedMuon();
+	    glbpt = recoCombinedGlbTrack->pt();
+	    glbeta = recoCombinedGlbTrack->eta();
+	    glbphi = recoCombinedGlbTrack->phi();
+	  }
+	  if(halfPtEnergy) mu_glbtrk_pt_h.push_back(muoncompact::floatToHalf(glbpt));
+	  else mu_glbtrk_pt.push_back(glbpt);
+	  mu_glbtrk_eta_q.push_back(muoncompact::encodeEta(glbeta));
+	  mu_glbtrk_phi_q.push_back(muoncompact::encodePhi(glbphi));
+	}
+    }
+
+}
+
+
+// ------------ function to match the muons among themselves
+// ------------ and to the global tracks
+void
+MuonObjectInfoExtractor::matchMuons()
+{
+  mu_nearmu_idx.clear();
+  mu_nearmu_dr.clear();
+  mu_glbtrk_idx.clear();
+  mu_glbtrk_dr.clear();
+
+  //get eta and phi of the muons and of their global tracks from
+  //whichever branches are filled; in the plain branches the non-global
+  //muons have -999 and are skipped, in the compact ones only the global
+  //muons have a global track
+  std::vector<float> eta, phi, trketa, trkphi;
+  std::vector<bool> use, hastrk;
+  if(compactEncoding){
+    for(unsigned int j=0;j<mu_eta_q.size();j++){
+      eta.push_back(muoncompact::decodeEta(mu_eta_q[j]));
+      phi.push_back(muoncompact::decodePhi(mu_phi_q[j]));
+      use.push_back(true);
+      trketa.push_back(muoncompact::decodeEta(mu_glbtrk_eta_q[j]));
+      trkphi.push_back(muoncompact::decodePhi(mu_glbtrk_phi_q[j]));
+      hastrk.push_back(muoncompact::unpackIsGlobal(mu_flags[j]));
+    }
+  }
+  else{
+    for(unsigned int j=0;j<mu_eta.size();j++){
+      eta.push_back(mu_eta[j]);
+      phi.push_back(mu_phi[j]);
+      use.push_back(mu_pt[j]>=0);
+      trketa.push_back(mu_glbtrk_eta[j]);
+      trkphi.push_back(mu_glbtrk_phi[j]);
+      hastrk.push_back(mu_glbtrk_pt[j]>=0);
+    }
+  }
+
+  //put the muons in the eta-phi grid, so each muon is only compared
+  //to the muons in the neighbouring cells instead of to all of them
+  matchGrid->clear();
+  for(unsigned int j=0;j<eta.size();j++){
+    if(use[j]) matchGrid->insert(eta[j],phi[j],j);
+  }
+  matchGrid->build();
+
+  for(unsigned int j=0;j<eta.size();j++){
+    int idx = -1;
+    float dr = -999;
+    if(use[j]){
+      idx = matchGrid->nearest(eta[j],phi[j],j,dr);
+      if(idx<0) dr = -999;
+    }
+    mu_nearmu_idx.push_back(idx);
+    mu_nearmu_dr.push_back(dr);
+  }
+
+  //the same with the global tracks in their own grid; a muon usually
+  //finds its own track, and a different index flags an ambiguous pair
+  trackGrid->clear();
+  for(unsigned int j=0;j<trketa.size();j++){
+    if(hastrk[j]) trackGrid->insert(trketa[j],trkphi[j],j);
+  }
+  trackGrid->build();
+
+  for(unsigned int j=0;j<eta.size();j++){
+    int idx = -1;
+    float dr = -999;
+    if(use[j]){
+      idx = trackGrid->nearest(eta[j],phi[j],-1,dr);
+      if(idx<0) dr = -999;
+    }
+    mu_glbtrk_idx.push_back(idx);
+    mu_glbtrk_dr.push_back(dr);
+  }
+}
+
+// ------------ function to keep the statistics of the current chunk
+void
+MuonObjectInfoExtractor::fillZoneMap()
+{
+  zoneMap.fillEvent(runno,evtno,nmu);
+  if(compactEncoding){
+    //use the values as a reader will decode them
+    for(unsigned int j=0;j<mu_eta_q.size();j++){
+      float pt = halfPtEnergy ? muoncompact::halfToFloat(mu_pt_h[j]) : mu_pt[j];
+      zoneMap.fillMuon(pt,muoncompact::decodeEta(mu_eta_q[j]));
+    }
+  }
+  else{
+    for(unsigned int j=0;j<mu_pt.size();j++){
+      //skip the -999 placeholders of the non-global muons
+      if(mu_pt[j]<0) continue;
+      zoneMap.fillMuon(mu_pt[j],mu_eta[j]);
+    }
+  }
+  if(zoneMap.nEvents>=flushEntries) closeZoneMapChunk();
+}
+
+// ------------ function to store the zone map of the current chunk
+void
+MuonObjectInfoExtractor::closeZoneMapChunk()
+{
+  if(zoneMap.nEvents>0) zonetree->Fill();
+  zoneMap.reset(0,mytree->GetEntries());
+}
+
+// ------------ function to react when the job gets close to its memory budget
+void
+MuonObjectInfoExtractor::relieveMemoryPressure()
+{
+  //write out what the baskets hold now, and start a new zone map.
+  //In ROOT 5 FlushBaskets does not start a cluster and autoflush stays
+  //on its grid of fAutoFlush entries, so from here on the zone map
+  //chunks are not aligned with the clusters; they only need to cover
+  //entry ranges, which is what selectEntryRanges works with.
+  mytree->FlushBaskets();
+  closeZoneMapChunk();
+  ++nForcedFlushes;
+  //the event index goes to its temporary file as well
+  if(!eventIndex.spill()){
+    edm::LogWarning("MuonObjectInfoExtractor")<<"could not spill the event index to a temporary file";
+  }
+  //and keep less in memory from now on
+  if(basketSize>kMinBasketSize){
+    basketSize = std::max(basketSize/2,kMinBasketSize);
+    mytree->SetBasketSize("*",basketSize);
+  }
+  if(flushEntries>kMinFlushEntries){
+    flushEntries = std::max(flushEntries/2,kMinFlushEntries);
+    mytree->SetAutoFlush(flushEntries);
+  }
+}
+
+// ------------ function to undo one step of relieveMemoryPressure
+// ------------ once the job is well under its memory budget again
+void
+MuonObjectInfoExtractor::growBuffers()
+{
+  if(basketSize<kBasketSize){
+    basketSize = std::min(2*basketSize,kBasketSize);
+    mytree->SetBasketSize("*",basketSize);
+  }
+  if(flushEntries<zoneMapChunkSize){
+    flushEntries = std::min(2*flushEntries,zoneMapChunkSize);
+    mytree->SetAutoFlush(flushEntries);
+  }
+}
 
 // ------------ method called once each job just before starting event loop  ------------
 void 
@@ -277,17 +580,60 @@ MuonObjectInfoExtractor::beginJob()
   mytree->Branch("runno",&runno,"runno/I");
   mytree->Branch("evtno",&evtno,"evtno/I");
   mytree->Branch("nmu",&nmu,"nmu/I");
-  mytree->Branch("mu_e",&mu_e);
-  mytree->Branch("mu_pt",&mu_pt);
-  mytree->Branch("mu_px",&mu_px);
-  mytree->Branch("mu_py",&mu_py);
-  mytree->Branch("mu_pz",&mu_pz);
-  mytree->Branch("mu_eta",&mu_eta);
-  mytree->Branch("mu_phi",&mu_phi);
-  mytree->Branch("mu_ch",&mu_ch);
-  mytree->Branch("mu_glbtrk_pt",&mu_glbtrk_pt);
-  mytree->Branch("mu_glbtrk_eta",&mu_glbtrk_eta);
-  mytree->Branch("mu_glbtrk_phi",&mu_glbtrk_phi);
+  if(compactEncoding){
+    //quantized branches, see interface/MuonCompactEncoding.h for the
+    //precision of each of them.  pt and energy fall back to floats if
+    //the requested precision is better than a half float can give.
+    halfPtEnergy = muoncompact::halfMeetsRelError(ptEnergyMaxRelError);
+    if(!halfPtEnergy){
+      edm::LogInfo("MuonObjectInfoExtractor")<<"ptEnergyMaxRelError = "<<ptEnergyMaxRelError
+        <<" is below the half float precision, pt and energy will be stored as floats";
+    }
+    mytree->Branch("mu_flags",&mu_flags);
+    if(halfPtEnergy){
+      mytree->Branch("mu_pt_h",&mu_pt_h);
+      mytree->Branch("mu_e_h",&mu_e_h);
+      mytree->Branch("mu_glbtrk_pt_h",&mu_glbtrk_pt_h);
+    }
+    else{
+      mytree->Branch("mu_pt",&mu_pt);
+      mytree->Branch("mu_e",&mu_e);
+      mytree->Branch("mu_glbtrk_pt",&mu_glbtrk_pt);
+    }
+    mytree->Branch("mu_eta_q",&mu_eta_q);
+    mytree->Branch("mu_phi_q",&mu_phi_q);
+    mytree->Branch("mu_glbtrk_eta_q",&mu_glbtrk_eta_q);
+    mytree->Branch("mu_glbtrk_phi_q",&mu_glbtrk_phi_q);
+  }
+  else{
+    mytree->Branch("mu_e",&mu_e);
+    mytree->Branch("mu_pt",&mu_pt);
+    mytree->Branch("mu_px",&mu_px);
+    mytree->Branch("mu_py",&mu_py);
+    mytree->Branch("mu_pz",&mu_pz);
+    mytree->Branch("mu_eta",&mu_eta);
+    mytree->Branch("mu_phi",&mu_phi);
+    mytree->Branch("mu_ch",&mu_ch);
+    mytree->Branch("mu_glbtrk_pt",&mu_glbtrk_pt);
+    mytree->Branch("mu_glbtrk_eta",&mu_glbtrk_eta);
+    mytree->Branch("mu_glbtrk_phi",&mu_glbtrk_phi);
+  }
+  mytree->Branch("mu_nearmu_idx",&mu_nearmu_idx);
+  mytree->Branch("mu_nearmu_dr",&mu_nearmu_dr);
+  mytree->Branch("mu_glbtrk_idx",&mu_glbtrk_idx);
+  mytree->Branch("mu_glbtrk_dr",&mu_glbtrk_dr);
+
+  //flush the baskets every zoneMapChunkSize entries, and keep one zone
+  //map per zoneMapChunkSize entries.  These are the clusters of the tree
+  //until a forced flush (see relieveMemoryPressure); in general a zone
+  //map covers an entry range, not a cluster.
+  flushEntries = zoneMapChunkSize;
+  basketSize = kBasketSize;
+  nForcedFlushes = 0;
+  mytree->SetAutoFlush(flushEntries);
+  zonetree = new TTree("zonemaps","Per-entry-range statistics of mytree");
+  muoncompact::branchZoneMap(zonetree,zoneMap);
+  zoneMap.reset(0,0);
 
 
   
@@ -298,8 +644,28 @@ void
 MuonObjectInfoExtractor::endJob() 
 {
 
-  //save file
+  //store the last (partial) chunk
+  closeZoneMapChunk();
+  //save file, closing it also deletes the trees it owns
   myfile->Write();
+  myfile->Close();
+  delete myfile;
+  myfile = 0;
+  mytree = 0;
+  zonetree = 0;
+
+  //the index is sorted and written once all the entries are known
+  if(writeEventIndex && !eventIndex.write("MuonObjectInfo.root.idx")){
+    edm::LogWarning("MuonObjectInfoExtractor")<<"could not write MuonObjectInfo.root.idx";
+  }
+
+  if(watchdog->enabled()){
+    edm::LogInfo("MuonObjectInfoExtractor")<<"memory high-water mark "<<watchdog->highWaterMB()
+      <<" MB for a budget of "<<watchdog->budgetMB()<<" MB, "<<nForcedFlushes<<" forced flushes, final basket size "
+      <<basketSize<<" bytes and "<<flushEntries<<" entries per cluster, event index of "<<eventIndex.size()
+      <<" entries ("<<eventIndex.nRuns()<<" runs spilled to disk)";
+  }
+  eventIndex.clear();
 
 }
 
@@ -0,0 +1,359 @@
+// -*- C++ -*-
+//
+// Package:    MuonObjectInfoExtractorToBinary
+// Class:      MuonObjectInfoExtractorToBinary
+//
+/**\class MuonObjectInfoExtractorToBinary MuonObjectInfoExtractorToBinary.cc PhysicsObjectsInfo/MuonObjectInfoExtractorToBinary/src/MuonObjectInfoExtractorToBinary.cc
+
+ Description: [Example on how to extract physics information from a CMS EDM Muon Collection
+               into a compact binary file]
+
+ Implementation:
+     [The layout of the file is described in interface/MuonBinaryFormat.h
+      and the encodings in interface/MuonCompactEncoding.h]
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+// $Id$
+//
+// Notes:
+//
+//
+
+
+// system include files
+#include <memory>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+//classes included to extract muon information
+#include "DataFormats/MuonReco/interface/Muon.h"
+#include "DataFormats/MuonReco/interface/MuonFwd.h"
+
+//compact encodings shared with the readers of the binary file
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonBinaryFormat.h"
+//watchdog for the memory budget of the job
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MemoryWatchdog.h"
+//(run, lumi, event) -> row group index written next to the binary file
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonEventIndex.h"
+
+//additional classes for storage, containers and operations
+#include<vector>
+#include<string>
+#include<fstream>
+#include<algorithm>
+
+
+
+//
+// class declaration
+//
+
+class MuonObjectInfoExtractorToBinary : public edm::EDAnalyzer {
+   public:
+      explicit MuonObjectInfoExtractorToBinary(const edm::ParameterSet&);
+      ~MuonObjectInfoExtractorToBinary();
+
+      static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+
+   private:
+      virtual void beginJob() ;
+      virtual void analyze(const edm::Event&, const edm::EventSetup&);
+      virtual void endJob() ;
+
+      virtual void beginRun(edm::Run const&, edm::EventSetup const&);
+      virtual void endRun(edm::Run const&, edm::EventSetup const&);
+      virtual void beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&);
+      virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&);
+
+ //declare a function to do the muon analysis
+      void analyzeMuons(const edm::Event& iEvent, const edm::Handle<reco::MuonCollection> &muons);
+  //functions to encode the event and write a row group to the file
+  void dumpMuonsToBinary();
+  void flushRowGroup();
+  //declare the input tag for the muons collection to be used (read from cofiguration)
+  edm::InputTag muonsInput;
+  //largest relative error allowed on pt and energy
+  double ptEnergyMaxRelError;
+  //number of events per row group, shrinks under memory pressure
+  //and grows back up to the configured one
+  unsigned int rowGroupSize;
+  unsigned int maxRowGroupSize;
+  //memory budget of the job (0 means no budget)
+  MemoryWatchdog* watchdog;
+  unsigned int nForcedFlushes;
+  //write MuonObjectInfo.bin.idx to find events without scanning the file
+  bool writeEventIndex;
+  MuonEventIndexWriter eventIndex;
+
+  //Declare some variables for storage
+  std::ofstream myfile;
+  std::vector<unsigned char> buffer;
+  muoncompact::DeltaCoder coder;
+  uint8_t encoding;
+  //byte offset in the file of the row group being filled
+  uint64_t fileOffset;
+  uint64_t nevents;
+  //zone map of the current row group and of the ones already written
+  muoncompact::MuonZoneMap zoneMap;
+  std::vector<muoncompact::MuonZoneMap> zoneMaps;
+
+  //and declare variable that will go into the binary file
+  unsigned int runno; //run number
+  unsigned int lumino; //luminosity section
+  unsigned int evtno; //event number
+  std::vector<muoncompact::MuonBinaryMuon> mu;
+};
+
+//
+// constants, enums and typedefs
+//
+
+//smallest row group size used under memory pressure
+static const unsigned int kMinRowGroupSize = 10;
+
+//
+// static data member definitions
+//
+
+//
+// constructors and destructor
+//
+MuonObjectInfoExtractorToBinary::MuonObjectInfoExtractorToBinary(const edm::ParameterSet& iConfig)
+
+{
+  //This should match the configuration in the corresponding python file
+  muonsInput = iConfig.getParameter<edm::InputTag>("InputCollection");
+  ptEnergyMaxRelError = iConfig.getUntrackedParameter<double>("ptEnergyMaxRelError",1e-3);
+  rowGroupSize = iConfig.getUntrackedParameter<unsigned int>("rowGroupSize",1000);
+  if(rowGroupSize==0){
+    throw cms::Exception("Configuration")<<"MuonObjectInfoExtractorToBinary: rowGroupSize should be positive";
+  }
+  maxRowGroupSize = rowGroupSize;
+  writeEventIndex = iConfig.getUntrackedParameter<bool>("writeEventIndex",true);
+  watchdog = new MemoryWatchdog(iConfig.getUntrackedParameter<double>("memoryBudgetMB",0),
+                                iConfig.getUntrackedParameter<unsigned int>("memoryCheckInterval",100));
+
+}
+
+
+MuonObjectInfoExtractorToBinary::~MuonObjectInfoExtractorToBinary()
+{
+
+   // do anything here that needs to be done at desctruction time
+   // (e.g. close files, deallocate resources etc.)
+   delete watchdog;
+
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called for each event  ------------
+void
+MuonObjectInfoExtractorToBinary::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+   using namespace edm;
+
+   //get the global information first
+   runno = iEvent.id().run();
+   lumino = iEvent.id().luminosityBlock();
+   evtno  = iEvent.id().event();
+
+   //Declare a container (or handle) where to store your muons.
+   //https://twiki.cern.ch/twiki/bin/view/CMSPublic/SWGuideDataFormatRecoMuon
+   Handle<reco::MuonCollection> mymuons;
+
+   //See MuonObjectInfoExtractorToCsv.cc for a discussion on the input tag
+   iEvent.getByLabel(muonsInput, mymuons);
+
+   analyzeMuons(iEvent,mymuons);
+   dumpMuonsToBinary();
+   return;
+
+}
+
+// ------------ function to analyze muons
+void
+MuonObjectInfoExtractorToBinary::analyzeMuons(const edm::Event& iEvent, const edm::Handle<reco::MuonCollection> &muons)
+{
+  //clear the storage containers for this objects in this event
+  mu.clear();
+
+  //check if the collection is valid
+  if(muons.isValid()){
+	//loop over all the muons in this event.
+	//Unlike the csv example, all muons are kept: whether they are
+	//global or tracker muons is stored in the flags, so there
+	//is no need for -999 placeholders.
+	for (reco::MuonCollection::const_iterator recoMu = muons->begin(); recoMu!=muons->end(); ++recoMu){
+	  muoncompact::MuonBinaryMuon m;
+	  m.flags = muoncompact::packFlags(recoMu->charge(),recoMu->isGlobalMuon(),recoMu->isTrackerMuon());
+	  m.pt = recoMu->pt();
+	  m.e = recoMu->energy();
+	  m.eta = recoMu->eta();
+	  m.phi = recoMu->phi();
+	  mu.push_back(m);
+	}
+  }
+
+}
+
+// ------------ function to encode the event into the buffer
+void MuonObjectInfoExtractorToBinary::dumpMuonsToBinary()
+{
+  //the event is found again from the start of its row group
+  if(writeEventIndex) eventIndex.add(runno,lumino,evtno,nevents,zoneMap.offset,mu.size());
+  coder.encode(buffer,runno,evtno);
+  muoncompact::putVarint(buffer,mu.size());
+  zoneMap.fillEvent(runno,evtno,mu.size());
+  for (unsigned int j=0;j<mu.size();j++){
+    muoncompact::putMuon(buffer,encoding,mu[j]);
+    //the zone map must see the values as a reader will decode them
+    float pt = (encoding & muoncompact::kHalfPtEnergy) ?
+      muoncompact::halfToFloat(muoncompact::floatToHalf(mu[j].pt)) : mu[j].pt;
+    zoneMap.fillMuon(pt,muoncompact::decodeEta(muoncompact::encodeEta(mu[j].eta)));
+  }
+  ++nevents;
+  if(zoneMap.nEvents>=rowGroupSize) flushRowGroup();
+
+  //close to the memory budget: write the row group now, give its
+  //buffer back and keep smaller row groups from now on.  Well under
+  //the budget again: go back towards the configured size, one step
+  //at a time.
+  MemoryState memory = watchdog->check();
+  if(memory==kMemoryPressure){
+    flushRowGroup();
+    std::vector<unsigned char>().swap(buffer);
+    rowGroupSize = std::max(rowGroupSize/2,kMinRowGroupSize);
+    ++nForcedFlushes;
+    if(!eventIndex.spill()){
+      edm::LogWarning("MuonObjectInfoExtractorToBinary")<<"could not spill the event index to a temporary file";
+    }
+  }
+  else if(memory==kMemoryRoom){
+    rowGroupSize = std::min(2*rowGroupSize,maxRowGroupSize);
+  }
+}
+
+// ------------ function to write the current row group to the file
+void MuonObjectInfoExtractorToBinary::flushRowGroup()
+{
+  if(zoneMap.nEvents>0){
+    zoneMap.size = buffer.size();
+    myfile.write(reinterpret_cast<const char*>(&buffer[0]),buffer.size());
+    fileOffset += buffer.size();
+    zoneMaps.push_back(zoneMap);
+    buffer.clear();
+  }
+  //each row group can be decoded on its own
+  coder.reset();
+  zoneMap.reset(fileOffset,nevents);
+}
+
+
+// ------------ method called once each job just before starting event loop  ------------
+void
+MuonObjectInfoExtractorToBinary::beginJob()
+{
+  //choose the encoding of pt and energy: half floats unless
+  //the requested precision is better than what they can give
+  encoding = 0;
+  if(muoncompact::halfMeetsRelError(ptEnergyMaxRelError)){
+    encoding |= muoncompact::kHalfPtEnergy;
+  }
+  else{
+    edm::LogInfo("MuonObjectInfoExtractorToBinary")<<"ptEnergyMaxRelError = "<<ptEnergyMaxRelError
+      <<" is below the half float precision, pt and energy will be stored as 32-bit floats";
+  }
+
+  //Define storage
+  myfile.open("MuonObjectInfo.bin",std::ios::out|std::ios::binary);
+  buffer.clear();
+  muoncompact::putBinaryHeader(buffer,encoding);
+  myfile.write(reinterpret_cast<const char*>(&buffer[0]),buffer.size());
+  fileOffset = buffer.size();
+  buffer.clear();
+  nevents = 0;
+  nForcedFlushes = 0;
+  zoneMaps.clear();
+  coder.reset();
+  zoneMap.reset(fileOffset,nevents);
+
+}
+
+// ------------ method called once each job just after ending the event loop  ------------
+void
+MuonObjectInfoExtractorToBinary::endJob()
+{
+
+  //write the last row group and the footer with the zone maps
+  flushRowGroup();
+  muoncompact::putFooter(buffer,fileOffset,zoneMaps);
+  myfile.write(reinterpret_cast<const char*>(&buffer[0]),buffer.size());
+  buffer.clear();
+  //save file
+  myfile.close();
+  if(writeEventIndex && !eventIndex.write("MuonObjectInfo.bin.idx")){
+    edm::LogWarning("MuonObjectInfoExtractorToBinary")<<"could not write MuonObjectInfo.bin.idx";
+  }
+
+  if(watchdog->enabled()){
+    edm::LogInfo("MuonObjectInfoExtractorToBinary")<<"memory high-water mark "<<watchdog->highWaterMB()
+      <<" MB for a budget of "<<watchdog->budgetMB()<<" MB, "<<nForcedFlushes<<" forced flushes, final row group size "
+      <<rowGroupSize<<" events, event index of "<<eventIndex.size()<<" entries ("<<eventIndex.nRuns()
+      <<" runs spilled to disk)";
+  }
+  eventIndex.clear();
+
+}
+
+// ------------ method called when starting to processes a run  ------------
+void
+MuonObjectInfoExtractorToBinary::beginRun(edm::Run const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method called when ending the processing of a run  ------------
+void
+MuonObjectInfoExtractorToBinary::endRun(edm::Run const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method called when starting to processes a luminosity block  ------------
+void
+MuonObjectInfoExtractorToBinary::beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method called when ending the processing of a luminosity block  ------------
+void
+MuonObjectInfoExtractorToBinary::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MuonObjectInfoExtractorToBinary::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  //The following says we do not know what parameters are allowed so do no validation
+  // Please change this to state exactly what you do use, even if it is no parameters
+  edm::ParameterSetDescription desc;
+  desc.setUnknown();
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MuonObjectInfoExtractorToBinary);
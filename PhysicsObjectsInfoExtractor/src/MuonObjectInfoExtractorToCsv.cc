@@ -31,6 +31,8 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 //classes included to extract muon information
 #include "DataFormats/MuonReco/interface/Muon.h"
@@ -50,6 +52,9 @@
 #include<fstream>
 #include<sstream>
 
+//(run, lumi, event) -> row index written next to the csv file
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonEventIndex.h"
+
 
 
 //
@@ -78,12 +83,28 @@ class MuonObjectInfoExtractorToCsv : public edm::EDAnalyzer {
       void analyzeMuons(const edm::Event& iEvent, const edm::Handle<reco::MuonCollection> &muons);
   //function to store info in csv
   void dumpMuonsToCsv();
+  //same, but one row per muon plus a table of events
+  void dumpMuonsToLongCsv();
   //declare the input tag for the muons collection to be used (read from cofiguration)
   edm::InputTag muonsInput;
   int maxNumObjt;
+  //"wide" (one row per event) or "long" (one row per muon)
+  std::string outputSchema;
+  bool longSchema;
+  //number of events with more muons than maxNumObjt (wide schema only)
+  int ntruncated;
+  //write <csv file>.idx to find events without scanning the file
+  bool writeEventIndex;
+  MuonEventIndexWriter eventIndex;
+  unsigned long long nrows;
+  //bytes written so far to myfile and myeventsfile, i.e. the offset of
+  //the next row, counted here instead of asking the streams (tellp)
+  uint64_t nbytes;
+  uint64_t neventsbytes;
 
   //Declare some variables for storage
   std::ofstream myfile;
+  std::ofstream myeventsfile; //long schema only
   int maxpart;
   std::ostringstream oss;
   std::string theHeader;
@@ -91,6 +112,7 @@ class MuonObjectInfoExtractorToCsv : public edm::EDAnalyzer {
 
   //and declare variable that will go into the root tree
   int runno; //run number
+  int lumino; //luminosity section
   int evtno; //event number
   int nmu;//number of muons in the event
   std::string mu_partype; //type of particle
@@ -121,6 +143,13 @@ MuonObjectInfoExtractorToCsv::MuonObjectInfoExtractorToCsv(const edm::ParameterS
   //This should match the configuration in the corresponding python file
   muonsInput = iConfig.getParameter<edm::InputTag>("InputCollection");
   maxNumObjt = iConfig.getUntrackedParameter<int>("maxNumberMuons",5);
+  outputSchema = iConfig.getUntrackedParameter<std::string>("outputSchema","wide");
+  if(outputSchema!="wide" && outputSchema!="long"){
+    throw cms::Exception("Configuration")<<"MuonObjectInfoExtractorToCsv: unknown outputSchema '"
+      <<outputSchema<<"', it should be 'wide' or 'long'";
+  }
+  longSchema = (outputSchema=="long");
+  writeEventIndex = iConfig.getUntrackedParameter<bool>("writeEventIndex",true);
 
 }
 
@@ -146,6 +175,7 @@ MuonObjectInfoExtractorToCsv::analyze(const edm::Event& iEvent, const edm::Event
 
    //get the global information first
    runno = iEvent.id().run();
+   lumino = iEvent.id().luminosityBlock();
    evtno  = iEvent.id().event();
 
    //Declare a container (or handle) where to store your muons.
@@ -174,7 +204,8 @@ MuonObjectInfoExtractorToCsv::analyze(const edm::Event& iEvent, const edm::Event
    //We do need to pass the event.  We could have also passed
    //the event setup if it were needed.
    analyzeMuons(iEvent,mymuons);
-   dumpMuonsToCsv();
+   if(longSchema) dumpMuonsToLongCsv();
+   else dumpMuonsToCsv();
    return;
 
 }
@@ -224,41 +255,93 @@ MuonObjectInfoExtractorToCsv::analyzeMuons(const edm::Event& iEvent, const edm::
 void MuonObjectInfoExtractorToCsv::dumpMuonsToCsv()
 {
   unsigned int maxnumobjt = maxNumObjt;
+  //muons beyond maxnumobjt do not fit in the row
+  if(nmu>maxNumObjt) ++ntruncated;
   if(nmu>0){
+  if(writeEventIndex) eventIndex.add(runno,lumino,evtno,nrows,nbytes,nmu);
+  ++nrows;
+  //the row is put together first, so that its length is known
+  std::ostringstream row;
   oss.str("");oss.clear();oss<<runno;
-  myfile<<oss.str();
+  row<<oss.str();
   oss.str("");oss.clear();oss<<evtno;
-  myfile<<","<<oss.str();
+  row<<","<<oss.str();
     for (unsigned int j=0;j<maxnumobjt;j++){
       oss.str("");oss.clear();oss<<mu_partype;
-      myfile<<","<<oss.str();
+      row<<","<<oss.str();
       oss.str("");oss.clear();oss<<mu_e[j];
-      j<mu_e.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_e.size() ? row<<","<<oss.str():row<<",0.0";
       //      std::cout<<maxnumobjt<<"\t"<<nmu<<"\t"<<mu_e.size()<<"\t"<<mu_e[j]<<"\t"<<oss.str()<<std::endl;
       oss.str("");oss.clear();oss<<mu_px[j];
-      j<mu_px.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_px.size() ? row<<","<<oss.str():row<<",0.0";
       oss.str("");oss.clear();oss<<mu_py[j];
-      j<mu_py.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_py.size() ? row<<","<<oss.str():row<<",0.0";
       oss.str("");oss.clear();oss<<mu_pz[j];
-      j<mu_pz.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_pz.size() ? row<<","<<oss.str():row<<",0.0";
       oss.str("");oss.clear();oss<<mu_pt[j];
-      j<mu_pt.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_pt.size() ? row<<","<<oss.str():row<<",0.0";
       oss.str("");oss.clear();oss<<mu_eta[j];
-      j<mu_eta.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_eta.size() ? row<<","<<oss.str():row<<",0.0";
       oss.str("");oss.clear();oss<<mu_phi[j];
-      j<mu_phi.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_phi.size() ? row<<","<<oss.str():row<<",0.0";
       oss.str("");oss.clear();oss<<mu_ch[j];
-      j<mu_ch.size() ? myfile<<","<<oss.str():myfile<<",0.0";
+      j<mu_ch.size() ? row<<","<<oss.str():row<<",0.0";
     }
-  myfile<<"\n";
+  row<<"\n";
+  const std::string& line = row.str();
+  myfile<<line;
+  nbytes += line.size();
   }
 }
 
+// ------------ function to store muons in the long (normalized) schema
+void MuonObjectInfoExtractorToCsv::dumpMuonsToLongCsv()
+{
+  //the index points to the row of the event in the events file,
+  //and to its first muon row, if any, in the muons file
+  if(writeEventIndex){
+    eventIndex.add(runno,lumino,evtno,nrows,neventsbytes,mu_e.size(),
+                   mu_e.empty() ? kNoMuonRows : nbytes);
+  }
+  ++nrows;
+  //one row per event, also for events without muons
+  std::ostringstream row;
+  row<<runno<<","<<evtno<<","<<nmu<<"\n";
+  myeventsfile<<row.str();
+  neventsbytes += row.str().size();
+  //and one row per muon, so nothing is padded or truncated
+  std::ostringstream rows;
+  for (unsigned int j=0;j<mu_e.size();j++){
+    rows<<runno<<","<<evtno<<","<<j<<","<<mu_partype
+        <<","<<mu_e[j]<<","<<mu_px[j]<<","<<mu_py[j]<<","<<mu_pz[j]
+        <<","<<mu_pt[j]<<","<<mu_eta[j]<<","<<mu_phi[j]<<","<<mu_ch[j]<<"\n";
+  }
+  const std::string& lines = rows.str();
+  myfile<<lines;
+  nbytes += lines.size();
+}
+
 
 // ------------ method called once each job just before starting event loop  ------------
 void 
 MuonObjectInfoExtractorToCsv::beginJob()
 {
+  ntruncated = 0;
+  nrows = 0;
+  if(longSchema){
+    //Define storage: a table of muons keyed by (Run,Event,Index)
+    //and a table of events keyed by (Run,Event)
+    const std::string muonsHeader = "Run,Event,Index,type,E,px,py,pz,pt,eta,phi,Q\n";
+    const std::string eventsHeader = "Run,Event,nmu\n";
+    myfile.open("MuonObjectInfo_muons.csv");
+    myfile<<muonsHeader;
+    nbytes = muonsHeader.size();
+    myeventsfile.open("MuonObjectInfo_events.csv");
+    myeventsfile<<eventsHeader;
+    neventsbytes = eventsHeader.size();
+    return;
+  }
+
   //Define storage
   myfile.open("MuonObjectInfo.csv");
   //Write the header.
@@ -271,6 +354,8 @@ MuonObjectInfoExtractorToCsv::beginJob()
   }
   
   myfile<<theHeader<<"\n";
+  nbytes = theHeader.size()+1;
+  neventsbytes = 0;
 
 }
 
@@ -279,8 +364,18 @@ void
 MuonObjectInfoExtractorToCsv::endJob() 
 {
 
+  if(ntruncated>0){
+    edm::LogWarning("MuonObjectInfoExtractorToCsv")<<ntruncated<<" events had more than "<<maxNumObjt
+      <<" muons and were truncated, use outputSchema = 'long' to keep them all";
+  }
   //save file
   myfile.close();
+  if(longSchema) myeventsfile.close();
+  std::string indexName = longSchema ? "MuonObjectInfo_events.csv.idx" : "MuonObjectInfo.csv.idx";
+  if(writeEventIndex && !eventIndex.write(indexName)){
+    edm::LogWarning("MuonObjectInfoExtractorToCsv")<<"could not write "<<indexName;
+  }
+  eventIndex.clear();
 
 }
 
@@ -0,0 +1,242 @@
+// -*- C++ -*-
+//
+// Package:    MuonObjectInfoExtractorToShm
+// Class:      MuonObjectInfoExtractorToShm
+//
+/**\class MuonObjectInfoExtractorToShm MuonObjectInfoExtractorToShm.cc PhysicsObjectsInfo/MuonObjectInfoExtractorToShm/src/MuonObjectInfoExtractorToShm.cc
+
+ Description: [Example on how to extract physics information from a CMS EDM Muon Collection
+               into a shared-memory ring buffer, for monitoring processes on the same node]
+
+ Implementation:
+     [The layout of the ring and the consumer library are in interface/MuonShmRing.h]
+*/
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+// $Id$
+//
+// Notes:
+//
+//
+
+
+// system include files
+#include <memory>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+//classes included to extract muon information
+#include "DataFormats/MuonReco/interface/Muon.h"
+#include "DataFormats/MuonReco/interface/MuonFwd.h"
+
+//ring buffer shared with the consumers
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonShmRing.h"
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonCompactEncoding.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+//additional classes for storage, containers and operations
+#include<string>
+
+
+
+//
+// class declaration
+//
+
+class MuonObjectInfoExtractorToShm : public edm::EDAnalyzer {
+   public:
+      explicit MuonObjectInfoExtractorToShm(const edm::ParameterSet&);
+      ~MuonObjectInfoExtractorToShm();
+
+      static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+
+   private:
+      virtual void beginJob() ;
+      virtual void analyze(const edm::Event&, const edm::EventSetup&);
+      virtual void endJob() ;
+
+      virtual void beginRun(edm::Run const&, edm::EventSetup const&);
+      virtual void endRun(edm::Run const&, edm::EventSetup const&);
+      virtual void beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&);
+      virtual void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&);
+
+ //declare a function to fill the record of this event in place
+      void analyzeMuons(const edm::Event& iEvent, const edm::Handle<reco::MuonCollection> &muons, muoncompact::MuonShmRecord& rec);
+  //declare the input tag for the muons collection to be used (read from cofiguration)
+  edm::InputTag muonsInput;
+  //name of the shared-memory segment and number of records in the ring
+  std::string shmName;
+  unsigned int ringCapacity;
+  //what to do with slow consumers: "drop" or "block"
+  std::string slowConsumerPolicy;
+  unsigned int blockTimeoutMs;
+
+  //the ring buffer
+  muoncompact::MuonShmProducer producer;
+};
+
+//
+// constants, enums and typedefs
+//
+
+//
+// static data member definitions
+//
+
+//
+// constructors and destructor
+//
+MuonObjectInfoExtractorToShm::MuonObjectInfoExtractorToShm(const edm::ParameterSet& iConfig)
+
+{
+  //This should match the configuration in the corresponding python file
+  muonsInput = iConfig.getParameter<edm::InputTag>("InputCollection");
+  shmName = iConfig.getUntrackedParameter<std::string>("shmName","/MuonObjectInfo");
+  ringCapacity = iConfig.getUntrackedParameter<unsigned int>("ringCapacity",4096);
+  slowConsumerPolicy = iConfig.getUntrackedParameter<std::string>("slowConsumerPolicy","drop");
+  blockTimeoutMs = iConfig.getUntrackedParameter<unsigned int>("blockTimeoutMs",100);
+  if(slowConsumerPolicy!="drop" && slowConsumerPolicy!="block"){
+    throw cms::Exception("Configuration")<<"MuonObjectInfoExtractorToShm: unknown slowConsumerPolicy '"
+      <<slowConsumerPolicy<<"', it should be 'drop' or 'block'";
+  }
+
+}
+
+
+MuonObjectInfoExtractorToShm::~MuonObjectInfoExtractorToShm()
+{
+
+   // do anything here that needs to be done at desctruction time
+   // (e.g. close files, deallocate resources etc.)
+
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called for each event  ------------
+void
+MuonObjectInfoExtractorToShm::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
+   using namespace edm;
+
+   //Declare a container (or handle) where to store your muons.
+   //https://twiki.cern.ch/twiki/bin/view/CMSPublic/SWGuideDataFormatRecoMuon
+   Handle<reco::MuonCollection> mymuons;
+
+   //See MuonObjectInfoExtractorToCsv.cc for a discussion on the input tag
+   iEvent.getByLabel(muonsInput, mymuons);
+
+   //the record is filled directly in the shared memory and
+   //becomes visible to the consumers on commit()
+   muoncompact::MuonShmRecord* rec = producer.begin();
+   rec->run = iEvent.id().run();
+   rec->lumi = iEvent.id().luminosityBlock();
+   rec->event = iEvent.id().event();
+   analyzeMuons(iEvent,mymuons,*rec);
+   producer.commit();
+   return;
+
+}
+
+// ------------ function to analyze muons
+void
+MuonObjectInfoExtractorToShm::analyzeMuons(const edm::Event& iEvent, const edm::Handle<reco::MuonCollection> &muons, muoncompact::MuonShmRecord& rec)
+{
+  rec.nmu = 0;
+  rec.nmuTotal = 0;
+
+  //check if the collection is valid
+  if(muons.isValid()){
+	rec.nmuTotal = muons->size();
+	//loop over all the muons in this event; the record has room
+	//for kShmMaxMuons of them, nmuTotal tells if some did not fit
+	for (reco::MuonCollection::const_iterator recoMu = muons->begin(); recoMu!=muons->end() && rec.nmu<muoncompact::kShmMaxMuons; ++recoMu){
+	  muoncompact::MuonShmMuon& m = rec.muons[rec.nmu++];
+	  m.e = recoMu->energy();
+	  m.pt = recoMu->pt();
+	  m.px = recoMu->px();
+	  m.py = recoMu->py();
+	  m.pz = recoMu->pz();
+	  m.eta = recoMu->eta();
+	  m.phi = recoMu->phi();
+	  m.charge = recoMu->charge();
+	  m.flags = muoncompact::packFlags(recoMu->charge(),recoMu->isGlobalMuon(),recoMu->isTrackerMuon());
+	}
+  }
+
+}
+
+
+// ------------ method called once each job just before starting event loop  ------------
+void
+MuonObjectInfoExtractorToShm::beginJob()
+{
+  //Define storage
+  muoncompact::MuonShmPolicy policy = slowConsumerPolicy=="block" ? muoncompact::kShmBlock : muoncompact::kShmDrop;
+  if(!producer.create(shmName,ringCapacity,policy,blockTimeoutMs)){
+    throw cms::Exception("MuonObjectInfoExtractorToShm")<<"could not create the shared memory segment '"<<shmName<<"': "<<producer.error();
+  }
+
+}
+
+// ------------ method called once each job just after ending the event loop  ------------
+void
+MuonObjectInfoExtractorToShm::endJob()
+{
+
+  edm::LogInfo("MuonObjectInfoExtractorToShm")<<producer.published()<<" records published to "<<shmName
+    <<", "<<producer.evicted()<<" slow consumers evicted";
+  //remove the segment, consumers still attached can finish reading it
+  producer.close();
+
+}
+
+// ------------ method called when starting to processes a run  ------------
+void
+MuonObjectInfoExtractorToShm::beginRun(edm::Run const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method called when ending the processing of a run  ------------
+void
+MuonObjectInfoExtractorToShm::endRun(edm::Run const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method called when starting to processes a luminosity block  ------------
+void
+MuonObjectInfoExtractorToShm::beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method called when ending the processing of a luminosity block  ------------
+void
+MuonObjectInfoExtractorToShm::endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&)
+{
+}
+
+// ------------ method fills 'descriptions' with the allowed parameters for the module  ------------
+void
+MuonObjectInfoExtractorToShm::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  //The following says we do not know what parameters are allowed so do no validation
+  // Please change this to state exactly what you do use, even if it is no parameters
+  edm::ParameterSetDescription desc;
+  desc.setUnknown();
+  descriptions.addDefault(desc);
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(MuonObjectInfoExtractorToShm);
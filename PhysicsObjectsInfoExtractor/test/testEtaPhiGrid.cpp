@@ -0,0 +1,135 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testEtaPhiGrid.cpp
+//
+// Compares EtaPhiGrid::nearest() of interface/EtaPhiGrid.h with a brute-force
+// search over all pairs, for dRMax from 0.001 to 7, with objects gathered
+// around phi = +-pi (where the angle wraps) and phi = 0 (where the cell
+// index of the grid wraps), and some beyond the eta range of the grid.
+// Returns the number of failed checks.
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/EtaPhiGrid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <sstream>
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+static double uniform(double lo, double hi)
+{
+  return lo+(hi-lo)*(rand()/(RAND_MAX+1.0));
+}
+
+//phi back into [-pi,pi)
+static double wrap(double phi)
+{
+  while(phi>=M_PI) phi -= 2*M_PI;
+  while(phi<-M_PI) phi += 2*M_PI;
+  return phi;
+}
+
+//objects in small clusters, a fair share of them close to phi = +-pi
+//or to phi = 0, so that most have a neighbour within dRMax whatever
+//dRMax is
+static void makeObjects(double dRMax, size_t n, std::vector<float>& eta, std::vector<float>& phi)
+{
+  eta.clear();
+  phi.clear();
+  while(eta.size()<n){
+    double ceta = uniform(-6, 6);
+    int where = rand()%3;
+    double cphi = where==0 ? M_PI-uniform(0, 2*dRMax) : where==1 ? uniform(-dRMax, dRMax) : uniform(-M_PI, M_PI);
+    int size = 1+rand()%4;
+    for(int k=0;k<size && eta.size()<n;k++){
+      eta.push_back(ceta+uniform(-dRMax, dRMax));
+      phi.push_back(wrap(cphi+uniform(-dRMax, dRMax)));
+    }
+  }
+}
+
+//the closest object other than skip within dRMax, the slow way
+static int bruteNearest(const std::vector<float>& eta, const std::vector<float>& phi,
+                        float eta0, float phi0, int skip, double dRMax, float& dR)
+{
+  int best = -1;
+  dR = dRMax;
+  for(size_t j=0;j<eta.size();j++){
+    if(int(j)==skip) continue;
+    float d = EtaPhiGrid::deltaR(eta0, phi0, eta[j], phi[j]);
+    if(d<dR || (d==dR && best<0)){
+      dR = d;
+      best = j;
+    }
+  }
+  return best;
+}
+
+static void testAgainstBruteForce(double dRMax)
+{
+  const size_t nObjects = 300;
+  std::vector<float> eta, phi;
+  makeObjects(dRMax, nObjects, eta, phi);
+  EtaPhiGrid grid(dRMax);
+  for(size_t j=0;j<eta.size();j++) grid.insert(eta[j], phi[j], j);
+  grid.build();
+
+  //each object against the others, and random points against all
+  size_t mismatches = 0, matched = 0;
+  for(size_t j=0;j<2*nObjects;j++){
+    bool own = j<nObjects;
+    float eta0 = own ? eta[j] : uniform(-6, 6);
+    float phi0 = own ? phi[j] : wrap(uniform(-M_PI, M_PI));
+    int skip = own ? int(j) : -1;
+    float dr1, dr2;
+    int i1 = grid.nearest(eta0, phi0, skip, dr1);
+    int i2 = bruteNearest(eta, phi, eta0, phi0, skip, dRMax, dr2);
+    if(i1!=i2 && dr1!=dr2) ++mismatches;
+    if(i2>=0) ++matched;
+  }
+  std::ostringstream what;
+  what<<"the grid finds what the brute force finds for dRMax "<<dRMax;
+  check(mismatches==0, what.str().c_str());
+  std::ostringstream some;
+  some<<"some objects are matched for dRMax "<<dRMax;
+  check(matched>0, some.str().c_str());
+}
+
+//objects on either side of phi = +-pi, and of phi = 0, are close
+static void testWraparound()
+{
+  EtaPhiGrid grid(0.1);
+  grid.insert(0.5, M_PI-0.02, 0);
+  grid.insert(0.5, -M_PI+0.03, 1);
+  grid.insert(-1, -0.01, 2);
+  grid.insert(-1, 0.04, 3);
+  grid.build();
+  float dr;
+  check(grid.nearest(0.5, M_PI-0.02, 0, dr)==1 && std::fabs(dr-0.05)<1e-4, "match across phi = +-pi");
+  check(grid.nearest(-1, -0.01, 2, dr)==3 && std::fabs(dr-0.05)<1e-4, "match across phi = 0");
+  check(grid.nearest(0.5, 1.5, -1, dr)==-1 && dr==0.1f, "nothing near phi = 1.5");
+}
+
+int main()
+{
+  srand(5);
+  testWraparound();
+  const double dRMax[] = {0.001, 0.005, 0.01, 0.05, 0.1, 0.4, 1, 2, 3.5, 7};
+  for(size_t k=0;k<sizeof(dRMax)/sizeof(dRMax[0]);k++) testAgainstBruteForce(dRMax[k]);
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}
@@ -0,0 +1,139 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testMuonBinaryFormat.cpp
+//
+// Writes a MuonObjectInfo.bin-like file the way MuonObjectInfoExtractorToBinary
+// does, with both pt/energy encodings, and reads events back with
+// MuonBinaryReader::readEvent().  Returns the number of failed checks.
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonBinaryFormat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace muoncompact;
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+static double uniform(double lo, double hi)
+{
+  return lo+(hi-lo)*(rand()/(RAND_MAX+1.0));
+}
+
+//an event with the values it reads back with after the encoding
+static MuonBinaryEvent makeEvent(uint64_t i, uint8_t encoding)
+{
+  MuonBinaryEvent evt;
+  evt.run = 160404+i/5000;
+  evt.event = 1000000+(i*7)%5000;
+  int nmu = rand()%4;
+  for(int j=0;j<nmu;j++){
+    MuonBinaryMuon mu;
+    mu.flags = packFlags(rand()%2 ? 1 : -1, true, rand()%2);
+    mu.pt = uniform(5, 100);
+    mu.e = mu.pt*uniform(1, 3);
+    mu.eta = decodeEta(encodeEta(uniform(-2.4, 2.4)));
+    mu.phi = decodePhi(encodePhi(uniform(-M_PI, M_PI)));
+    if(encoding & kHalfPtEnergy){
+      mu.pt = halfToFloat(floatToHalf(mu.pt));
+      mu.e = halfToFloat(floatToHalf(mu.e));
+    }
+    evt.muons.push_back(mu);
+  }
+  return evt;
+}
+
+static bool sameEvent(const MuonBinaryEvent& a, const MuonBinaryEvent& b)
+{
+  if(a.run!=b.run || a.event!=b.event || a.muons.size()!=b.muons.size()) return false;
+  for(size_t j=0;j<a.muons.size();j++){
+    const MuonBinaryMuon& x = a.muons[j];
+    const MuonBinaryMuon& y = b.muons[j];
+    if(x.flags!=y.flags || x.pt!=y.pt || x.e!=y.e || x.eta!=y.eta || x.phi!=y.phi) return false;
+  }
+  return true;
+}
+
+static void testFile(uint8_t encoding)
+{
+  const char* path = "testMuonBinaryFormat.bin";
+  const uint64_t nEvents = 10000;
+  const uint32_t rowGroupSize = 1000;
+
+  //write it like MuonObjectInfoExtractorToBinary
+  std::vector<MuonBinaryEvent> events;
+  std::ofstream out(path, std::ios::out|std::ios::binary);
+  std::vector<unsigned char> buf;
+  putBinaryHeader(buf, encoding);
+  uint64_t offset = buf.size();
+  out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+  buf.clear();
+  DeltaCoder coder;
+  MuonZoneMap zm;
+  zm.reset(offset, 0);
+  std::vector<MuonZoneMap> zoneMaps;
+  for(uint64_t i=0;i<nEvents;i++){
+    events.push_back(makeEvent(i, encoding));
+    const MuonBinaryEvent& evt = events.back();
+    coder.encode(buf, evt.run, evt.event);
+    putVarint(buf, evt.muons.size());
+    zm.fillEvent(evt.run, evt.event, evt.muons.size());
+    for(size_t j=0;j<evt.muons.size();j++){
+      putMuon(buf, encoding, evt.muons[j]);
+      zm.fillMuon(evt.muons[j].pt, evt.muons[j].eta);
+    }
+    if(zm.nEvents>=rowGroupSize){
+      zm.size = buf.size();
+      out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+      offset += buf.size();
+      zoneMaps.push_back(zm);
+      buf.clear();
+      coder.reset();
+      zm.reset(offset, i+1);
+    }
+  }
+  putFooter(buf, offset, zoneMaps);
+  out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+  out.close();
+
+  MuonBinaryReader reader;
+  check(reader.open(path), "open the binary file");
+  check(reader.encoding()==encoding, "encoding in the header");
+  check(reader.zoneMaps().size()==nEvents/rowGroupSize, "one zone map per row group");
+
+  //random access through readEvent
+  bool same = true;
+  for(uint64_t i=0;i<nEvents;i+=7){
+    MuonBinaryEvent evt;
+    if(!reader.readEvent(i, evt) || !sameEvent(evt, events[i])) same = false;
+  }
+  check(same, "readEvent gives back the events written");
+  MuonBinaryEvent evt;
+  check(!reader.readEvent(nEvents, evt), "readEvent past the end");
+
+  remove(path);
+}
+
+int main()
+{
+  srand(1);
+  testFile(kHalfPtEnergy);
+  testFile(0);
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}
@@ -0,0 +1,154 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testMuonCompactEncoding.cpp
+//
+// Round-trip checks of the encodings in interface/MuonCompactEncoding.h.
+// Returns the number of failed checks (0 on success).
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonCompactEncoding.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace muoncompact;
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+static double uniform(double lo, double hi)
+{
+  return lo+(hi-lo)*(rand()/(RAND_MAX+1.0));
+}
+
+static void testHalf()
+{
+  //every finite half float comes back unchanged
+  bool exact = true;
+  for(uint32_t h=0;h<0x10000;h++){
+    if((h & 0x7c00)==0x7c00) continue; //inf and nan
+    if(floatToHalf(halfToFloat(h))!=h) exact = false;
+  }
+  check(exact, "half -> float -> half is exact");
+
+  //and a float in the normal range comes back within 2^-11
+  double worst = 0;
+  for(int i=0;i<1000000;i++){
+    float x = std::exp(uniform(std::log(6.2e-5), std::log(65000.)));
+    double rel = std::fabs(halfToFloat(floatToHalf(x))-x)/x;
+    if(rel>worst) worst = rel;
+  }
+  std::cout<<"half float: worst relative error "<<worst<<std::endl;
+  check(worst<=kHalfMaxRelError, "half float relative error");
+  check(halfToFloat(floatToHalf(-3.5f))==-3.5f, "half float sign");
+  check(halfToFloat(floatToHalf(1e6f))==kHalfMaxValue, "half float clamps at 65504");
+  check(halfMeetsRelError(1e-3) && !halfMeetsRelError(1e-4), "halfMeetsRelError");
+}
+
+static void testEtaPhi()
+{
+  double worstEta = 0, worstPhi = 0;
+  for(int i=0;i<1000000;i++){
+    //the last half step below kEtaRange is clamped to the top code
+    double eta = uniform(-kEtaRange, kEtaRange-kEtaStep/2);
+    double deta = std::fabs(decodeEta(encodeEta(eta))-eta);
+    if(deta>worstEta) worstEta = deta;
+    double phi = uniform(-M_PI, M_PI);
+    double dphi = std::fabs(decodePhi(encodePhi(phi))-phi);
+    if(dphi>M_PI) dphi = 2*M_PI-dphi;
+    if(dphi>worstPhi) worstPhi = dphi;
+  }
+  std::cout<<"eta: worst error "<<worstEta<<", phi: worst error "<<worstPhi<<std::endl;
+  //half a step, plus the float rounding of the decoded value
+  check(worstEta<=kEtaStep/2+1e-6, "eta quantization error");
+  check(worstPhi<=kPhiStep/2+1e-6, "phi quantization error");
+  check(std::fabs(decodePhi(encodePhi(M_PI))+M_PI)<1e-6, "phi wraps at pi");
+  check(decodeEta(encodeEta(100.))==decodeEta(32767), "eta is clamped");
+}
+
+static void testFlags()
+{
+  for(int charge=-1;charge<=1;charge++){
+    for(int g=0;g<2;g++){
+      for(int t=0;t<2;t++){
+        uint8_t flags = packFlags(charge, g, t);
+        check(unpackCharge(flags)==charge && unpackIsGlobal(flags)==bool(g) &&
+              unpackIsTracker(flags)==bool(t), "flags round trip");
+      }
+    }
+  }
+}
+
+static void testVarint()
+{
+  const int64_t values[] = {0, 1, -1, 63, -64, 64, 300, -300, 1LL<<40, -(1LL<<40),
+                            0x7fffffffffffffffLL, -0x7fffffffffffffffLL-1};
+  const size_t n = sizeof(values)/sizeof(values[0]);
+  std::vector<unsigned char> buf;
+  for(size_t i=0;i<n;i++) putVarint(buf, zigzag(values[i]));
+  putVarint(buf, ~0ULL);
+  size_t pos = 0;
+  for(size_t i=0;i<n;i++){
+    uint64_t v = 0;
+    size_t len = getVarint(&buf[0]+pos, buf.size()-pos, v);
+    check(len>0 && unzigzag(v)==values[i], "zigzag varint round trip");
+    pos += len;
+  }
+  uint64_t big = 0;
+  pos += getVarint(&buf[0]+pos, buf.size()-pos, big);
+  check(big==~0ULL && pos==buf.size(), "largest varint");
+  uint64_t v;
+  check(getVarint(&buf[0], 0, v)==0, "truncated varint is rejected");
+}
+
+static void testDeltaCoder()
+{
+  //runs change, events go up and down
+  const uint64_t runs[] = {160404, 160404, 160404, 160405, 160405, 1, 4000000000ULL};
+  const uint64_t events[] = {1234567, 1234568, 1000, 5, 6, 0, 1ULL<<40};
+  const size_t n = sizeof(runs)/sizeof(runs[0]);
+  std::vector<unsigned char> buf;
+  DeltaCoder encoder;
+  for(size_t i=0;i<n;i++) encoder.encode(buf, runs[i], events[i]);
+  DeltaCoder decoder;
+  size_t pos = 0;
+  for(size_t i=0;i<n;i++){
+    uint64_t run, event;
+    size_t len = decoder.decode(&buf[0]+pos, buf.size()-pos, run, event);
+    check(len>0 && run==runs[i] && event==events[i], "DeltaCoder round trip");
+    pos += len;
+  }
+  check(pos==buf.size(), "DeltaCoder reads what it wrote");
+
+  //consecutive events of a run take 2 bytes
+  std::vector<unsigned char> small;
+  DeltaCoder coder;
+  coder.encode(small, 160404, 1000);
+  size_t first = small.size();
+  coder.encode(small, 160404, 1001);
+  check(small.size()-first==2, "consecutive events take 2 bytes");
+}
+
+int main()
+{
+  srand(1);
+  testHalf();
+  testEtaPhi();
+  testFlags();
+  testVarint();
+  testDeltaCoder();
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}
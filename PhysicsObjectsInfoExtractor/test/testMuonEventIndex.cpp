@@ -0,0 +1,131 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testMuonEventIndex.cpp
+//
+// Writes an index with MuonEventIndexWriter and looks every event up again
+// with MuonEventIndex, and checks that an index spilled to disk in sorted
+// runs and merged comes out the same as one sorted in memory.  Returns the
+// number of failed checks.
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonEventIndex.h"
+
+#include <stdio.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+//events in the order of the output, not sorted
+static void fill(MuonEventIndexWriter& writer, uint64_t n, uint64_t spillEvery = 0)
+{
+  for(uint64_t i=0;i<n;i++){
+    uint32_t nmu = i%4;
+    writer.add(160404+i%3, i/1000, (i*7919)%1000003, i, 100*i, nmu, nmu ? 40*i : kNoMuonRows);
+    if(spillEvery && i%spillEvery==spillEvery-1) writer.spill();
+  }
+}
+
+static std::string contents(const char* path)
+{
+  std::ifstream in(path, std::ios::in|std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void testLookups()
+{
+  const char* path = "testMuonEventIndex.idx";
+  const uint64_t n = 100000;
+
+  MuonEventIndexWriter writer;
+  fill(writer, n);
+  check(writer.size()==n, "writer size");
+  check(writer.write(path), "write the index");
+
+  MuonEventIndex index;
+  check(index.open(path), "open the index");
+  check(index.size()==n, "index size");
+
+  bool sorted = true;
+  for(const MuonEventIndexEntry* it=index.begin();it+1<index.end();++it){
+    if(it[1]<it[0]) sorted = false;
+  }
+  check(sorted, "entries are sorted");
+
+  bool found = true;
+  for(uint64_t i=0;i<n;i++){
+    uint32_t nmu = i%4;
+    const MuonEventIndexEntry* e = index.find(160404+i%3, (i*7919)%1000003);
+    if(!e || e->entry!=i || e->lumi!=i/1000 || e->offset!=100*i || e->nmu!=nmu ||
+       e->muonOffset!=(nmu ? 40*i : kNoMuonRows)) found = false;
+  }
+  check(found, "every event is found with its fields");
+  check(index.find(160404, 5000000)==0, "missing event");
+  check(index.find(1, 0)==0, "missing run");
+  check(index.find(160404, 0, 0)!=0 && index.find(160404, 1, 0)==0, "lookup with the lumi section");
+  index.close();
+
+  //a file that is not an index is rejected
+  FILE* f = fopen(path, "wb");
+  fputs("not an index, just some text", f);
+  fclose(f);
+  check(!index.open(path), "reject a bad file");
+
+  remove(path);
+}
+
+//runs spilled when the writer is full, and when asked to (as under
+//memory pressure), merge into the same file as a sort in memory
+static void testSpill()
+{
+  const uint64_t n = 100000;
+  MuonEventIndexWriter inMemory;
+  fill(inMemory, n);
+  check(inMemory.nRuns()==0, "nothing spilled below the limit");
+  check(inMemory.write("testMuonEventIndex_memory.idx"), "write the index sorted in memory");
+
+  MuonEventIndexWriter spilled(1000);
+  fill(spilled, n, 30011);
+  check(spilled.size()==n, "spilled writer size");
+  check(spilled.nRuns()>n/1000, "runs spilled at the limit and on request");
+  check(spilled.memoryBytes()<=1000*sizeof(MuonEventIndexEntry), "memory stays under the limit");
+  check(spilled.write("testMuonEventIndex_spilled.idx"), "write the merged index");
+  std::string a = contents("testMuonEventIndex_memory.idx");
+  std::string b = contents("testMuonEventIndex_spilled.idx");
+  check(!a.empty() && a==b, "the merged index is the same as the one sorted in memory");
+  check(spilled.write("testMuonEventIndex_spilled.idx") &&
+        contents("testMuonEventIndex_spilled.idx")==a, "write() can be called again");
+
+  //a writer can be reused after clear()
+  spilled.clear();
+  check(spilled.size()==0 && spilled.nRuns()==0, "clear() forgets the spilled runs");
+  fill(spilled, 10);
+  check(spilled.write("testMuonEventIndex_spilled.idx"), "write after clear()");
+  MuonEventIndex index;
+  check(index.open("testMuonEventIndex_spilled.idx") && index.size()==10, "only the new entries");
+  index.close();
+
+  remove("testMuonEventIndex_memory.idx");
+  remove("testMuonEventIndex_spilled.idx");
+}
+
+int main()
+{
+  testLookups();
+  testSpill();
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}
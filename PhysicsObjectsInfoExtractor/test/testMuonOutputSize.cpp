@@ -0,0 +1,214 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testMuonOutputSize.cpp
+//
+// Writes the same synthetic sample as wide and long CSV (formatted like
+// MuonObjectInfoExtractorToCsv) and as MuonObjectInfo.bin with both pt/energy
+// encodings, and prints the bytes per event and the time it took to
+// encode and write each file.  This is what the size table of
+// doc/READMEMuons.md comes from.  Fails if the compact binary output is
+// not much smaller than the CSV one.
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonBinaryFormat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+using namespace muoncompact;
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+static double uniform(double lo, double hi)
+{
+  return lo+(hi-lo)*(rand()/(RAND_MAX+1.0));
+}
+
+static double now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec+1e-6*tv.tv_usec;
+}
+
+//what the extractors see for one event
+struct SampleMuon {
+  float e, px, py, pz, pt, eta, phi;
+  int charge;
+};
+
+struct SampleEvent {
+  unsigned int run;
+  unsigned int event;
+  std::vector<SampleMuon> muons;
+};
+
+//0 to 3 muons per event, pt from 5 to 70 GeV, |eta| < 2.4
+static std::vector<SampleEvent> makeSample(size_t nEvents)
+{
+  srand(3);
+  std::vector<SampleEvent> sample(nEvents);
+  for(size_t i=0;i<nEvents;i++){
+    SampleEvent& evt = sample[i];
+    evt.run = 160404;
+    evt.event = 100000000+i;
+    int nmu = rand()%4;
+    for(int j=0;j<nmu;j++){
+      SampleMuon mu;
+      mu.pt = uniform(5, 70);
+      mu.eta = uniform(-2.4, 2.4);
+      mu.phi = uniform(-M_PI, M_PI);
+      mu.px = mu.pt*std::cos(mu.phi);
+      mu.py = mu.pt*std::sin(mu.phi);
+      mu.pz = mu.pt*std::sinh(mu.eta);
+      mu.e = std::sqrt(mu.px*mu.px+mu.py*mu.py+mu.pz*mu.pz+0.1057*0.1057);
+      mu.charge = rand()%2 ? 1 : -1;
+      evt.muons.push_back(mu);
+    }
+  }
+  return sample;
+}
+
+//one row per event with muons, maxNumberMuons slots padded with 0.0
+static size_t writeWideCsv(const std::vector<SampleEvent>& sample, const char* path)
+{
+  const unsigned int maxNumberMuons = 10;
+  std::ofstream out(path);
+  for(size_t i=0;i<sample.size();i++){
+    const SampleEvent& evt = sample[i];
+    if(evt.muons.empty()) continue;
+    std::ostringstream row;
+    row<<evt.run<<","<<evt.event;
+    for(unsigned int j=0;j<maxNumberMuons;j++){
+      row<<",G";
+      if(j<evt.muons.size()){
+        const SampleMuon& mu = evt.muons[j];
+        row<<","<<mu.e<<","<<mu.px<<","<<mu.py<<","<<mu.pz<<","<<mu.pt
+           <<","<<mu.eta<<","<<mu.phi<<","<<mu.charge;
+      }
+      else row<<",0.0,0.0,0.0,0.0,0.0,0.0,0.0,0.0";
+    }
+    row<<"\n";
+    out<<row.str();
+  }
+  out.close();
+  std::ifstream in(path, std::ios::in|std::ios::binary|std::ios::ate);
+  return in.tellg();
+}
+
+//one row per event in the events file, one per muon in the muons file
+static size_t writeLongCsv(const std::vector<SampleEvent>& sample, const char* eventsPath,
+                           const char* muonsPath)
+{
+  std::ofstream events(eventsPath);
+  std::ofstream muons(muonsPath);
+  for(size_t i=0;i<sample.size();i++){
+    const SampleEvent& evt = sample[i];
+    events<<evt.run<<","<<evt.event<<","<<evt.muons.size()<<"\n";
+    for(size_t j=0;j<evt.muons.size();j++){
+      const SampleMuon& mu = evt.muons[j];
+      muons<<evt.run<<","<<evt.event<<","<<j<<",G"
+           <<","<<mu.e<<","<<mu.px<<","<<mu.py<<","<<mu.pz<<","<<mu.pt
+           <<","<<mu.eta<<","<<mu.phi<<","<<mu.charge<<"\n";
+    }
+  }
+  events.close();
+  muons.close();
+  std::ifstream in1(eventsPath, std::ios::in|std::ios::binary|std::ios::ate);
+  std::ifstream in2(muonsPath, std::ios::in|std::ios::binary|std::ios::ate);
+  return static_cast<size_t>(in1.tellg())+static_cast<size_t>(in2.tellg());
+}
+
+static size_t writeBinary(const std::vector<SampleEvent>& sample, const char* path, uint8_t encoding)
+{
+  const uint32_t rowGroupSize = 1000;
+  std::ofstream out(path, std::ios::out|std::ios::binary);
+  std::vector<unsigned char> buf;
+  putBinaryHeader(buf, encoding);
+  uint64_t offset = buf.size();
+  DeltaCoder coder;
+  MuonZoneMap zm;
+  zm.reset(offset, 0);
+  std::vector<MuonZoneMap> zoneMaps;
+  for(size_t i=0;i<sample.size();i++){
+    const SampleEvent& evt = sample[i];
+    coder.encode(buf, evt.run, evt.event);
+    putVarint(buf, evt.muons.size());
+    zm.fillEvent(evt.run, evt.event, evt.muons.size());
+    for(size_t j=0;j<evt.muons.size();j++){
+      const SampleMuon& in = evt.muons[j];
+      MuonBinaryMuon mu;
+      mu.flags = packFlags(in.charge, true, false);
+      mu.pt = in.pt;
+      mu.e = in.e;
+      mu.eta = in.eta;
+      mu.phi = in.phi;
+      putMuon(buf, encoding, mu);
+      zm.fillMuon(in.pt, in.eta);
+    }
+    if(zm.nEvents>=rowGroupSize || i+1==sample.size()){
+      zm.size = buf.size();
+      out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+      offset += buf.size();
+      zoneMaps.push_back(zm);
+      buf.clear();
+      coder.reset();
+      zm.reset(offset, i+1);
+    }
+  }
+  putFooter(buf, offset, zoneMaps);
+  out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+  offset += buf.size();
+  out.close();
+  return offset;
+}
+
+int main()
+{
+  const size_t nEvents = 100000;
+  std::vector<SampleEvent> sample = makeSample(nEvents);
+
+  double t0 = now();
+  size_t wide = writeWideCsv(sample, "testMuonOutputSize.csv");
+  double t1 = now();
+  size_t binFloat = writeBinary(sample, "testMuonOutputSize_float.bin", 0);
+  double t2 = now();
+  size_t binHalf = writeBinary(sample, "testMuonOutputSize_half.bin", kHalfPtEnergy);
+  double t3 = now();
+  size_t longCsv = writeLongCsv(sample, "testMuonOutputSize_events.csv", "testMuonOutputSize_muons.csv");
+  double t4 = now();
+
+  std::cout<<nEvents<<" events, bytes per event and time to encode and write:"<<std::endl;
+  std::cout<<"  CSV, wide schema:        "<<double(wide)/nEvents<<" bytes, "<<(t1-t0)*1e3<<" ms"<<std::endl;
+  std::cout<<"  CSV, long schema:        "<<double(longCsv)/nEvents<<" bytes, "<<(t4-t3)*1e3<<" ms"<<std::endl;
+  std::cout<<"  binary, float pt/energy: "<<double(binFloat)/nEvents<<" bytes, "<<(t2-t1)*1e3<<" ms"<<std::endl;
+  std::cout<<"  binary, half pt/energy:  "<<double(binHalf)/nEvents<<" bytes, "<<(t3-t2)*1e3<<" ms"<<std::endl;
+
+  check(binHalf<binFloat, "half floats are smaller than floats");
+  check(10*binHalf<wide, "the binary output is more than 10 times smaller than the CSV");
+  check(longCsv<wide, "the long CSV schema is smaller than the wide one");
+
+  remove("testMuonOutputSize.csv");
+  remove("testMuonOutputSize_events.csv");
+  remove("testMuonOutputSize_muons.csv");
+  remove("testMuonOutputSize_float.bin");
+  remove("testMuonOutputSize_half.bin");
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}
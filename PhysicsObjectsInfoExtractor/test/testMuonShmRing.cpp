@@ -0,0 +1,297 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testMuonShmRing.cpp
+//
+// Checks of the shared-memory ring of interface/MuonShmRing.h: ordered
+// delivery, lapping under the drop policy, eviction and rejoin under the
+// block policy, the consumer limit, the reclaim of the slot of a consumer
+// that died, the refusal of a live segment and the replacement of a stale
+// one, producer liveness, and torn-read detection with the consumer in
+// another process.  Returns the number of failed checks.
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonShmRing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace muoncompact;
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+//a name no other job uses
+static std::string segmentName(const char* what)
+{
+  std::ostringstream name;
+  name<<"/testMuonShmRing_"<<what<<"_"<<getpid();
+  return name.str();
+}
+
+//every field of record n is derived from n, so a torn record shows up.
+//With spin, the muons are written slowly, to widen the window in which
+//a reader can catch the record half written.
+static void publish(MuonShmProducer& producer, uint64_t n, int spin = 0)
+{
+  MuonShmRecord* rec = producer.begin();
+  rec->event = n;
+  rec->run = 3*n;
+  rec->lumi = n/100;
+  rec->nmu = kShmMaxMuons;
+  rec->nmuTotal = kShmMaxMuons;
+  for(uint32_t j=0;j<kShmMaxMuons;j++){
+    for(volatile int k=0;k<spin;k++){}
+    rec->muons[j].pt = n+j;
+  }
+  producer.commit();
+}
+
+static bool consistent(const MuonShmRecord* rec)
+{
+  uint64_t n = rec->event;
+  if(rec->run!=3*n || rec->lumi!=n/100 || rec->nmu!=kShmMaxMuons) return false;
+  for(uint32_t j=0;j<kShmMaxMuons;j++) if(rec->muons[j].pt!=float(n+j)) return false;
+  return true;
+}
+
+//read all that is there; returns the events read, in order
+static std::vector<uint64_t> drain(MuonShmConsumer& consumer)
+{
+  std::vector<uint64_t> events;
+  const MuonShmRecord* rec;
+  while((rec = consumer.peek())){
+    uint64_t n = rec->event;
+    if(consumer.release()) events.push_back(n);
+  }
+  return events;
+}
+
+static int activeConsumers(const std::string& name)
+{
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if(fd<0) return -1;
+  void* p = mmap(0, sizeof(MuonShmHeader), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if(p==MAP_FAILED) return -1;
+  const MuonShmHeader* header = static_cast<const MuonShmHeader*>(p);
+  int n = 0;
+  for(uint32_t c=0;c<kShmMaxConsumers;c++){
+    if(header->consumers[c].active.load()==kShmActive) ++n;
+  }
+  munmap(p, sizeof(MuonShmHeader));
+  return n;
+}
+
+static void testOrdered()
+{
+  std::string name = segmentName("ordered");
+  MuonShmProducer producer;
+  check(producer.create(name, 16, kShmDrop, 0), "create");
+  MuonShmConsumer consumer;
+  check(consumer.open(name), "open");
+  check(consumer.peek()==0, "nothing to read yet");
+  for(uint64_t n=0;n<10;n++) publish(producer, n);
+  std::vector<uint64_t> events = drain(consumer);
+  bool ordered = events.size()==10;
+  for(size_t k=0;ordered && k<events.size();k++) ordered = events[k]==k;
+  check(ordered, "records come in order");
+  check(consumer.lost()==0, "nothing lost");
+  check(producer.published()==10, "published");
+}
+
+static void testDropLapping()
+{
+  std::string name = segmentName("drop");
+  MuonShmProducer producer;
+  check(producer.create(name, 16, kShmDrop, 0), "create");
+  MuonShmConsumer consumer;
+  consumer.open(name);
+  //the consumer reads one record and then falls three rings behind
+  publish(producer, 0);
+  const MuonShmRecord* rec = consumer.peek();
+  check(rec && rec->event==0, "first record");
+  for(uint64_t n=1;n<50;n++) publish(producer, n);
+  //the record being read was overwritten in the meantime
+  check(!consumer.release(), "release() sees the overwrite");
+  std::vector<uint64_t> events = drain(consumer);
+  check(!events.empty() && events.back()==49, "the newest record is read");
+  bool increasing = true;
+  for(size_t k=1;k<events.size();k++) if(events[k]<=events[k-1]) increasing = false;
+  check(increasing, "records stay in order after lapping");
+  check(events.size()+consumer.lost()==50, "every record is read or counted as lost");
+  check(producer.evicted()==0, "nobody is evicted with the drop policy");
+}
+
+static void testBlockEviction()
+{
+  std::string name = segmentName("block");
+  MuonShmProducer producer;
+  check(producer.create(name, 8, kShmBlock, 1), "create");
+  MuonShmConsumer slow, other;
+  slow.open(name);
+  //the producer waits 1 ms for the slow consumer, then evicts it
+  for(uint64_t n=0;n<20;n++) publish(producer, n);
+  check(producer.evicted()==1, "the slow consumer is evicted");
+  //a consumer joining now gets another slot than the evicted one
+  check(other.open(name), "open a second consumer");
+  check(activeConsumers(name)==1, "the evicted consumer is no longer active");
+  //the evicted consumer rejoins at the head through its own slot
+  check(slow.peek()==0, "nothing new after the rejoin");
+  check(slow.lost()==20, "the rejoin counts what was lost");
+  check(activeConsumers(name)==2, "both consumers active, in their own slots");
+  publish(producer, 20);
+  std::vector<uint64_t> a = drain(slow);
+  std::vector<uint64_t> b = drain(other);
+  check(a.size()==1 && a[0]==20 && b.size()==1 && b[0]==20, "both read the new record");
+  //the producer is not held back by a consumer that keeps up
+  for(uint64_t n=21;n<100;n++){
+    publish(producer, n);
+    drain(slow);
+    drain(other);
+  }
+  check(producer.evicted()==1, "no more evictions");
+}
+
+static void testConsumerLimit()
+{
+  std::string name = segmentName("limit");
+  MuonShmProducer producer;
+  check(producer.create(name, 8, kShmDrop, 0), "create");
+  std::vector<MuonShmConsumer*> consumers;
+  bool opened = true;
+  for(uint32_t c=0;c<kShmMaxConsumers;c++){
+    consumers.push_back(new MuonShmConsumer);
+    if(!consumers.back()->open(name)) opened = false;
+  }
+  check(opened, "kShmMaxConsumers consumers can attach");
+  MuonShmConsumer extra;
+  check(!extra.open(name), "one more is refused");
+  consumers[3]->close();
+  check(extra.open(name), "a closed consumer frees its slot");
+
+  //a consumer in another process dies while it holds a slot
+  consumers[5]->close();
+  pid_t pid = fork();
+  if(pid==0){
+    MuonShmConsumer dying;
+    _exit(dying.open(name) ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  check(WIFEXITED(status) && WEXITSTATUS(status)==0, "the forked consumer attached");
+  check(activeConsumers(name)==int(kShmMaxConsumers), "its slot is still taken");
+  MuonShmConsumer reclaimer;
+  check(reclaimer.open(name), "the slot of the dead consumer is reclaimed");
+  for(size_t c=0;c<consumers.size();c++) delete consumers[c];
+}
+
+static void testSegmentOwnership()
+{
+  std::string name = segmentName("owner");
+  MuonShmProducer producer;
+  check(producer.create(name, 8, kShmDrop, 0), "create");
+  MuonShmProducer second;
+  check(!second.create(name, 8, kShmDrop, 0), "a live segment is not replaced");
+  check(!second.error().empty(), "and the reason is given");
+
+  MuonShmConsumer consumer;
+  consumer.open(name);
+  check(consumer.producerAlive(), "the producer is alive");
+  publish(producer, 0);
+  producer.close();
+  check(!consumer.producerAlive(), "a closed producer is seen");
+  check(drain(consumer).size()==1, "what was published can still be read");
+
+  //a producer in another process dies without closing its segment
+  consumer.close();
+  pid_t pid = fork();
+  if(pid==0){
+    MuonShmProducer* dying = new MuonShmProducer;
+    _exit(dying->create(name, 8, kShmDrop, 0) ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  check(WIFEXITED(status) && WEXITSTATUS(status)==0, "the forked producer created the segment");
+  check(consumer.open(name), "open the segment of the dead producer");
+  check(!consumer.producerAlive(), "a dead producer is seen");
+  consumer.close();
+  MuonShmProducer next;
+  check(next.create(name, 8, kShmDrop, 0), "a stale segment is replaced");
+  check(consumer.open(name) && consumer.producerAlive(), "reopen the new segment");
+  publish(next, 7);
+  std::vector<uint64_t> events = drain(consumer);
+  check(events.size()==1 && events[0]==7, "read from the new segment");
+}
+
+//the consumer runs in another process and checks every record it accepts
+static void testCrossProcess(MuonShmPolicy policy)
+{
+  std::string name = segmentName(policy==kShmBlock ? "xblock" : "xdrop");
+  const uint64_t nRecords = 50000;
+  MuonShmProducer producer;
+  check(producer.create(name, 64, policy, 1000), "create");
+  int ready[2];
+  if(pipe(ready)!=0){
+    check(false, "pipe");
+    return;
+  }
+  pid_t pid = fork();
+  if(pid==0){
+    MuonShmConsumer consumer;
+    bool ok = consumer.open(name);
+    char c = 1;
+    if(write(ready[1], &c, 1)!=1) ok = false;
+    uint64_t nread = 0, torn = 0, last = 0;
+    while(ok && (nread==0 || last+1<nRecords)){
+      const MuonShmRecord* rec = consumer.peek();
+      if(!rec) continue;
+      bool good = consistent(rec);
+      uint64_t n = rec->event;
+      if(!consumer.release()) continue;
+      if(!good || (nread>0 && n<=last)) ++torn;
+      last = n;
+      ++nread;
+    }
+    //with the block policy nothing may be lost
+    bool complete = policy!=kShmBlock || (nread==nRecords && consumer.lost()==0);
+    _exit(ok && torn==0 && complete ? 0 : 1);
+  }
+  char c;
+  check(read(ready[0], &c, 1)==1, "the consumer is attached");
+  for(uint64_t n=0;n<nRecords;n++) publish(producer, n, 20);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ::close(ready[0]);
+  ::close(ready[1]);
+  check(WIFEXITED(status) && WEXITSTATUS(status)==0,
+        policy==kShmBlock ? "block: every record read, none torn" : "drop: no torn record accepted");
+  check(policy!=kShmBlock || producer.evicted()==0, "block: nobody evicted");
+}
+
+int main()
+{
+  testOrdered();
+  testDropLapping();
+  testBlockEviction();
+  testConsumerLimit();
+  testSegmentOwnership();
+  testCrossProcess(kShmDrop);
+  testCrossProcess(kShmBlock);
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}
@@ -0,0 +1,173 @@
+// -*- C++ -*-
+//
+// Package:    PhysicsObjectsInfoExtractor
+// File:       testMuonZoneMap.cpp
+//
+// Checks of the zone maps in interface/MuonZoneMap.h: serialization, the
+// conservative MuonZonePredicate::mayMatch(), and MuonBinaryReader::readSelected()
+// against a full scan of a binary file.  Returns the number of failed checks.
+//
+// Original Author:  agent (agent@local)
+//         Created:  Mon Oct 19 2026
+//
+
+#include "PhysicsObjectsInfo/PhysicsObjectsInfoExtractor/interface/MuonBinaryFormat.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <cmath>
+#include <iostream>
+
+using namespace muoncompact;
+
+static int nfailed = 0;
+
+static void check(bool ok, const char* what)
+{
+  if(!ok){
+    std::cout<<"FAILED: "<<what<<std::endl;
+    ++nfailed;
+  }
+}
+
+static double uniform(double lo, double hi)
+{
+  return lo+(hi-lo)*(rand()/(RAND_MAX+1.0));
+}
+
+static void testSerialization()
+{
+  MuonZoneMap zm;
+  zm.reset(123456789012ULL, 42);
+  check(zm.nEvents==0 && !zm.hasMuons(), "empty zone map");
+  zm.fillEvent(160404, 1000, 2);
+  zm.fillMuon(25.5f, -1.2f);
+  zm.fillMuon(3.25f, 2.3f);
+  zm.fillEvent(160405, 7, 0);
+  zm.size = 999;
+  std::vector<unsigned char> buf;
+  putZoneMap(buf, zm);
+  check(buf.size()==kZoneMapSize, "zone map size");
+  MuonZoneMap back;
+  getZoneMap(&buf[0], back);
+  check(back.offset==zm.offset && back.size==zm.size && back.firstEntry==zm.firstEntry &&
+        back.nEvents==2 && back.ptMin==3.25f && back.ptMax==25.5f &&
+        back.etaMin==-1.2f && back.etaMax==2.3f && back.nmuMin==0 && back.nmuMax==2 &&
+        back.runMin==160404 && back.runMax==160405 && back.eventMin==7 && back.eventMax==1000,
+        "zone map round trip");
+}
+
+static void testPredicate()
+{
+  MuonZoneMap zm;
+  zm.reset(0, 0);
+  zm.fillEvent(1, 10, 1);
+  zm.fillMuon(15, 2.5);
+  zm.fillEvent(1, 20, 1);
+  zm.fillMuon(30, -2.3);
+
+  MuonZonePredicate pred;
+  check(pred.mayMatch(zm), "no cut matches everything");
+  pred.ptMin = 40;
+  check(!pred.mayMatch(zm), "pt above the chunk maximum");
+  pred.ptMin = 20;
+  pred.absEtaMax = 2.1;
+  //pt > 20 only at eta -2.3, |eta| < 2.1 only at pt 15: the chunk
+  //cannot tell, so it must be read, but no event passes
+  check(pred.mayMatch(zm), "mayMatch is conservative");
+  check(!pred.matchesMuon(15, 2.5) && !pred.matchesMuon(30, -2.3), "matchesMuon");
+  MuonZonePredicate runCut;
+  runCut.runMin = 2;
+  check(!runCut.mayMatch(zm), "run outside the chunk");
+  MuonZonePredicate nmuCut;
+  nmuCut.nmuMin = 2;
+  check(!nmuCut.mayMatch(zm), "nmu outside the chunk");
+}
+
+static void testReadSelected()
+{
+  const char* path = "testMuonZoneMap.bin";
+  const uint64_t nEvents = 10000;
+  const uint32_t rowGroupSize = 1000;
+  const uint8_t encoding = kHalfPtEnergy;
+
+  //write it like MuonObjectInfoExtractorToBinary, with a slowly
+  //rising pt so that some row groups can be skipped
+  std::vector<MuonBinaryEvent> events;
+  std::ofstream out(path, std::ios::out|std::ios::binary);
+  std::vector<unsigned char> buf;
+  putBinaryHeader(buf, encoding);
+  uint64_t offset = buf.size();
+  out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+  buf.clear();
+  DeltaCoder coder;
+  MuonZoneMap zm;
+  zm.reset(offset, 0);
+  std::vector<MuonZoneMap> zoneMaps;
+  for(uint64_t i=0;i<nEvents;i++){
+    MuonBinaryEvent evt;
+    evt.run = 160404;
+    evt.event = i;
+    int nmu = rand()%4;
+    for(int j=0;j<nmu;j++){
+      MuonBinaryMuon mu;
+      mu.flags = packFlags(1, true, true);
+      mu.pt = halfToFloat(floatToHalf(uniform(5, 20)+i/200.));
+      mu.e = mu.pt;
+      mu.eta = decodeEta(encodeEta(uniform(-2.4, 2.4)));
+      mu.phi = 0;
+      evt.muons.push_back(mu);
+    }
+    events.push_back(evt);
+    coder.encode(buf, evt.run, evt.event);
+    putVarint(buf, evt.muons.size());
+    zm.fillEvent(evt.run, evt.event, evt.muons.size());
+    for(size_t j=0;j<evt.muons.size();j++){
+      putMuon(buf, encoding, evt.muons[j]);
+      zm.fillMuon(evt.muons[j].pt, evt.muons[j].eta);
+    }
+    if(zm.nEvents>=rowGroupSize){
+      zm.size = buf.size();
+      out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+      offset += buf.size();
+      zoneMaps.push_back(zm);
+      buf.clear();
+      coder.reset();
+      zm.reset(offset, i+1);
+    }
+  }
+  putFooter(buf, offset, zoneMaps);
+  out.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+  out.close();
+
+  MuonBinaryReader reader;
+  check(reader.open(path), "open the binary file");
+  check(reader.zoneMaps().size()==nEvents/rowGroupSize, "one zone map per row group");
+
+  //readSelected finds the same events as a full scan, reading less
+  MuonZonePredicate pred;
+  pred.ptMin = 55;
+  pred.absEtaMax = 2.1;
+  std::vector<uint64_t> expected;
+  for(uint64_t i=0;i<nEvents;i++) if(selectsEvent(pred, events[i])) expected.push_back(i);
+  std::vector<MuonBinaryEvent> selected;
+  check(reader.readSelected(pred, selected), "readSelected");
+  std::cout<<selected.size()<<" events selected reading "<<reader.rowGroupsRead()<<" of "
+           <<reader.zoneMaps().size()<<" row groups"<<std::endl;
+  bool same = !expected.empty() && selected.size()==expected.size();
+  for(size_t k=0;same && k<selected.size();k++) same = selected[k].event==expected[k];
+  check(same, "readSelected finds every selected event");
+  check(reader.rowGroupsRead()<reader.zoneMaps().size(), "readSelected skips row groups");
+
+  remove(path);
+}
+
+int main()
+{
+  srand(1);
+  testSerialization();
+  testPredicate();
+  testReadSelected();
+  if(nfailed==0) std::cout<<"all checks passed"<<std::endl;
+  return nfailed;
+}